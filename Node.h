@@ -1,21 +1,25 @@
 #ifndef NODE_H
 #define NODE_H
 
-// Definição da estrutura Node para a matriz esparsa
-// Representa um elemento não nulo da matriz 
-struct Node {
-    Node* direita;  // Próximo nó na mesma linha
-    Node* abaixo;   // Próximo nó na mesma coluna
-    int linha;      // Índice da linha do elemento
-    int coluna;     // Índice da coluna do elemento
-    double valor;   // Valor armazenado no nó
+// Definição da estrutura NodeT para a matriz esparsa
+// Representa um elemento não nulo da matriz, com valor do tipo T e índices do tipo Index
+template <typename T, typename Index>
+struct NodeT {
+    NodeT* direita; // Próximo nó na mesma linha
+    NodeT* abaixo;  // Próximo nó na mesma coluna
+    Index linha;    // Índice da linha do elemento
+    Index coluna;   // Índice da coluna do elemento
+    T valor;        // Valor armazenado no nó
 
     // Construtor do nó.
     // Índice da linha (padrão: -1, nó sentinela)
     // Índice da coluna (padrão: -1, nó sentinela)
-    // Valor armazenado no nó (padrão: 0.0)
-    Node(int i = -1, int j = -1, double val = 0.0) 
+    // Valor armazenado no nó (padrão: zero)
+    NodeT(Index i = -1, Index j = -1, T val = T())
         : direita(this), abaixo(this), linha(i), coluna(j), valor(val) {}
 };
 
-#endif
\ No newline at end of file
+// Nó da matriz usada pelo programa: valores double e índices int
+using Node = NodeT<double, int>;
+
+#endif
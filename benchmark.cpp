@@ -0,0 +1,1066 @@
+// Benchmark das operações da matriz esparsa
+// Sem argumentos, exibe o relatório completo. Com --json, roda a bateria de operações sobre as matrizes
+// sintéticas e grava os resultados em JSON, para comparação entre versões:
+// ./benchmark --json [resultado.json] [--linhas m] [--porLinha k] [--repeticoes r]
+// Compilação (acrescente -march=native para o núcleo AVX2/AVX-512 do produto matriz-vetor):
+// g++ -std=c++17 -O2 benchmark.cpp sparse_matrix.cpp node_pool.cpp csr_matrix.cpp sparse_ops.cpp thread_pool.cpp
+//     matrix_io.cpp mapped_file.cpp binary_format.cpp concurrent_matrix.cpp bsr_matrix.cpp -pthread -o benchmark
+
+#include "sparse_matrix.h"
+#include "sparse_ops.h"
+#include "matrix_io.h"
+#include "concurrent_matrix.h"
+#include "sparse_expr.h"
+#include "bsr_matrix.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+using namespace std;
+
+/* Gera uma matriz m x n com cerca de porLinha elementos por linha em colunas aleatórias
+ * Usa uma semente fixa para que a mesma matriz seja gerada em todas as execuções
+ * Preenche cada linha de uma só vez, com as colunas sorteadas em ordem crescente
+ */
+SparseMatrix* gerarAleatoria(int m, int n, int porLinha, unsigned semente) {
+    mt19937 gerador(semente);
+    uniform_int_distribution<int> coluna(1, n);
+    uniform_real_distribution<double> valor(0.5, 1.5);
+
+    SparseMatrix* matriz = new SparseMatrix(m, n);
+    vector<int> cols;
+    vector<double> valores;
+    for (int i = 1; i <= m; ++i) {
+        cols.clear();
+        for (int k = 0; k < porLinha; ++k) {
+            cols.push_back(coluna(gerador));
+        }
+        sort(cols.begin(), cols.end());
+        cols.erase(unique(cols.begin(), cols.end()), cols.end());
+        valores.clear();
+        for (size_t k = 0; k < cols.size(); ++k) {
+            valores.push_back(valor(gerador));
+        }
+        matriz->inserirLinha(i, cols, valores);
+    }
+    return matriz;
+}
+
+/* Mede a vazão de inserções e consultas aleatórias em uma matriz de m x m
+ * Sorteia as posições antecipadamente com semente fixa, para que as medições sejam reprodutíveis
+ * Insere nnz elementos em posições aleatórias e depois consulta as mesmas posições
+ * Exibe o número de operações por segundo de cada etapa
+ */
+void benchRandomAccess(int m, int nnz) {
+    mt19937 gerador(42);
+    uniform_int_distribution<int> indice(1, m);
+
+    vector<int> is(nnz), js(nnz);
+    for (int k = 0; k < nnz; ++k) {
+        is[k] = indice(gerador);
+        js[k] = indice(gerador);
+    }
+
+    SparseMatrix matriz(m, m);
+
+    auto inicio = chrono::steady_clock::now();
+    for (int k = 0; k < nnz; ++k) {
+        matriz.inserir(is[k], js[k], k + 1.0);
+    }
+    auto meio = chrono::steady_clock::now();
+
+    double soma = 0;
+    for (int k = 0; k < nnz; ++k) {
+        soma += matriz.get(is[k], js[k]);
+    }
+    auto fim = chrono::steady_clock::now();
+
+    double tempoInserir = chrono::duration<double>(meio - inicio).count();
+    double tempoGet = chrono::duration<double>(fim - meio).count();
+
+    cout << setw(9) << m << " linhas | "
+         << "inserir: " << setw(12) << fixed << setprecision(0) << nnz / tempoInserir << " op/s | "
+         << "get: " << setw(12) << nnz / tempoGet << " op/s"
+         << "  (checksum " << setprecision(1) << soma << ")\n";
+}
+
+/* Mede o tempo de carga e de destruição de uma matriz com nnz elementos
+ * Insere os elementos linha a linha, na mesma ordem dos arquivos de entrada
+ * Mede separadamente a carga, a limpeza com clear(), a recarga e a destruição
+ * Exibe os contadores de alocação do pool de nós ao final
+ */
+void benchLoadTeardown(int m, int porLinha) {
+    mt19937 gerador(7);
+    uniform_int_distribution<int> passo(1, 2 * (m / porLinha));
+
+    SparseMatrix* matriz = new SparseMatrix(m, m);
+
+    auto carregar = [&]() {
+        for (int i = 1; i <= m; ++i) {
+            int j = passo(gerador);
+            for (int k = 0; k < porLinha && j <= m; ++k, j += passo(gerador)) {
+                matriz->inserir(i, j, 1.0 + k);
+            }
+        }
+    };
+
+    auto t0 = chrono::steady_clock::now();
+    carregar();
+    auto t1 = chrono::steady_clock::now();
+    matriz->clear();
+    auto t2 = chrono::steady_clock::now();
+    carregar();
+    auto t3 = chrono::steady_clock::now();
+    NodePool::Contadores contadores = matriz->getContadoresAlocacao();
+    delete matriz;
+    auto t4 = chrono::steady_clock::now();
+
+    auto ms = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double, milli>(b - a).count();
+    };
+
+    cout << setw(9) << m << " linhas, " << porLinha << "/linha | "
+         << fixed << setprecision(1)
+         << "carga: " << ms(t0, t1) << " ms | clear: " << ms(t1, t2) << " ms | "
+         << "recarga: " << ms(t2, t3) << " ms | destrutor: " << ms(t3, t4) << " ms\n"
+         << "          nos alocados: " << contadores.alocados << ", liberados: " << contadores.liberados
+         << ", reutilizados: " << contadores.reutilizados << ", blocos: " << contadores.blocos << "\n";
+}
+
+/* Mede o tempo da multiplicação de duas matrizes aleatórias m x m
+ * Exibe o tempo, a quantidade de elementos do resultado e a vazão em milhões de produtos por segundo
+ */
+void benchMultiply(int m, int porLinha) {
+    SparseMatrix* A = gerarAleatoria(m, m, porLinha, 1);
+    SparseMatrix* B = gerarAleatoria(m, m, porLinha, 2);
+
+    auto inicio = chrono::steady_clock::now();
+    SparseMatrix* C = multiply(A, B);
+    auto fim = chrono::steady_clock::now();
+
+    double produtos = static_cast<double>(A->countNonZero()) * B->countNonZero() / m;
+    double segundos = chrono::duration<double>(fim - inicio).count();
+    cout << setw(9) << m << " linhas, " << setw(3) << porLinha << "/linha | "
+         << fixed << setprecision(1) << segundos * 1000 << " ms | nnz(C) = " << C->countNonZero()
+         << " | " << produtos / segundos / 1e6 << " M produtos/s\n";
+
+    delete A;
+    delete B;
+    delete C;
+}
+
+/* Gera uma matriz m x m formada por blocos b x b, com blocosPorLinha blocos em colunas de blocos aleatórias
+ * por linha de blocos; cada posição de um bloco é preenchida com probabilidade "preenchimento"
+ * Usa uma semente fixa para que a mesma matriz seja gerada em todas as execuções
+ */
+SparseMatrix* gerarBlocos(int m, int b, int blocosPorLinha, double preenchimento, unsigned semente) {
+    mt19937 gerador(semente);
+    int linhasBloco = (m + b - 1) / b;
+    uniform_int_distribution<int> colunaBloco(0, linhasBloco - 1);
+    uniform_real_distribution<double> valor(0.5, 1.5);
+    bernoulli_distribution ocupada(preenchimento);
+
+    SparseMatrix* matriz = new SparseMatrix(m, m);
+    vector<int> blocos, cols;
+    vector<double> valores;
+    for (int I = 0; I < linhasBloco; ++I) {
+        blocos.clear();
+        for (int k = 0; k < blocosPorLinha; ++k) {
+            blocos.push_back(colunaBloco(gerador));
+        }
+        sort(blocos.begin(), blocos.end());
+        blocos.erase(unique(blocos.begin(), blocos.end()), blocos.end());
+        for (int i = I * b + 1; i <= min(m, (I + 1) * b); ++i) {
+            cols.clear();
+            valores.clear();
+            for (int J : blocos) {
+                for (int j = J * b + 1; j <= min(m, (J + 1) * b); ++j) {
+                    if (ocupada(gerador)) {
+                        cols.push_back(j);
+                        valores.push_back(valor(gerador));
+                    }
+                }
+            }
+            matriz->inserirLinha(i, cols, valores);
+        }
+    }
+    return matriz;
+}
+
+/* Compara o produto elemento a elemento (multiplyCSR) com multiply, que escolhe sozinho o produto em blocos
+ * Gera duas matrizes com blocos b x b preenchidos na fração indicada e as congela, para que os dois
+ * caminhos partam das mesmas formas CSR. Com preenchimento baixo, multiply deve recusar os blocos e a
+ * diferença entre os tempos é o custo da amostragem feita por escolherBloco.
+ */
+void benchBlocos(int m, int b, int blocosPorLinha, double preenchimento) {
+    SparseMatrix* A = gerarBlocos(m, b, blocosPorLinha, preenchimento, 1);
+    SparseMatrix* B = gerarBlocos(m, b, blocosPorLinha, preenchimento, 2);
+    A->freeze();
+    B->freeze();
+
+    auto inicio = chrono::steady_clock::now();
+    SparseMatrix* escalar = multiplyCSR(*A->getCSR(), *B->getCSR());
+    auto meio = chrono::steady_clock::now();
+    SparseMatrix* automatico = multiply(A, B);
+    auto fim = chrono::steady_clock::now();
+
+    double msEscalar = chrono::duration<double, milli>(meio - inicio).count();
+    double msAutomatico = chrono::duration<double, milli>(fim - meio).count();
+    int escolhido = escolherBloco(*A->getCSR(), *B->getCSR());
+    cout << setw(9) << m << " linhas, blocos " << b << "x" << b << ", " << setw(3)
+         << static_cast<int>(preenchimento * 100) << "% cheios | elemento a elemento " << fixed << setprecision(1)
+         << msEscalar << " ms | multiply " << msAutomatico << " ms ("
+         << (escolhido ? "BSR " + to_string(escolhido) + "x" + to_string(escolhido) : string("CSR")) << ") | "
+         << setprecision(2) << msEscalar / msAutomatico << "x"
+         << (escalar->countNonZero() == automatico->countNonZero() ? "" : " | nnz(C) DIFERENTE") << "\n";
+
+    delete A;
+    delete B;
+    delete escalar;
+    delete automatico;
+}
+
+/* Compara A^T * A e A * A^T pelos núcleos simétricos (multiplyATA e multiplyAAT) com a transposição seguida
+ * de multiply, e a transposta copiada (transpose) com a vistaTransposta de uma matriz congelada
+ * A matriz tem m linhas e m / 4 colunas, de modo que A^T * A é menor e mais densa que A * A^T
+ */
+void benchGram(int m, int porLinha) {
+    SparseMatrix* A = gerarAleatoria(m, m / 4, porLinha, 1);
+    A->freeze(true);
+
+    auto inicio = chrono::steady_clock::now();
+    SparseMatrix* At = transpose(A);
+    SparseMatrix* ataComum = multiply(At, A);
+    auto meio = chrono::steady_clock::now();
+    SparseMatrix* ata = multiplyATA(A);
+    auto fim = chrono::steady_clock::now();
+    double msComum = chrono::duration<double, milli>(meio - inicio).count();
+    double msGram = chrono::duration<double, milli>(fim - meio).count();
+    cout << setw(9) << m << " x " << setw(6) << m / 4 << ", " << setw(2) << porLinha << "/linha | A^T * A: transpose + multiply "
+         << fixed << setprecision(1) << msComum << " ms, multiplyATA " << msGram << " ms ("
+         << setprecision(2) << msComum / msGram << "x) | nnz = " << ata->countNonZero() << "\n";
+
+    inicio = chrono::steady_clock::now();
+    SparseMatrix* aatComum = multiply(A, At);
+    meio = chrono::steady_clock::now();
+    SparseMatrix* aat = multiplyAAT(A);
+    fim = chrono::steady_clock::now();
+    msComum = chrono::duration<double, milli>(meio - inicio).count();
+    msGram = chrono::duration<double, milli>(fim - meio).count();
+    cout << setw(31) << "" << "| A * A^T: multiply " << setprecision(1) << msComum << " ms, multiplyAAT " << msGram
+         << " ms (" << setprecision(2) << msComum / msGram << "x) | nnz = " << aat->countNonZero() << "\n";
+
+    inicio = chrono::steady_clock::now();
+    SparseMatrix* copia = transpose(A);
+    meio = chrono::steady_clock::now();
+    SparseMatrix vista = A->vistaTransposta();
+    fim = chrono::steady_clock::now();
+    cout << setw(31) << "" << "| transpose " << setprecision(2) << chrono::duration<double, milli>(meio - inicio).count()
+         << " ms, vistaTransposta " << chrono::duration<double, milli>(fim - meio).count() << " ms\n";
+
+    delete A;
+    delete At;
+    delete ataComum;
+    delete ata;
+    delete aatComum;
+    delete aat;
+    delete copia;
+}
+
+/* Mede o acúmulo de várias atualizações aleatórias em uma matriz m x m
+ * Compara a soma que cria uma nova matriz a cada passo com a soma no próprio lugar (axpy)
+ */
+void benchAccumulate(int m, int porLinha, int atualizacoes) {
+    vector<SparseMatrix*> parcelas;
+    for (int k = 0; k < atualizacoes; ++k) {
+        parcelas.push_back(gerarAleatoria(m, m, porLinha, 100 + k));
+    }
+
+    auto t0 = chrono::steady_clock::now();
+    SparseMatrix* total = new SparseMatrix(m, m);
+    for (SparseMatrix* parcela : parcelas) {
+        SparseMatrix* novo = sum(total, parcela);
+        delete total;
+        total = novo;
+    }
+    auto t1 = chrono::steady_clock::now();
+    SparseMatrix acumulada(m, m);
+    for (SparseMatrix* parcela : parcelas) {
+        acumulada += *parcela;
+    }
+    auto t2 = chrono::steady_clock::now();
+
+    cout << setw(9) << m << " linhas, " << atualizacoes << " atualizacoes de " << porLinha << "/linha | "
+         << fixed << setprecision(1)
+         << "sum: " << chrono::duration<double, milli>(t1 - t0).count() << " ms | "
+         << "+=: " << chrono::duration<double, milli>(t2 - t1).count() << " ms | nnz = "
+         << acumulada.countNonZero() << " / " << total->countNonZero() << "\n";
+
+    delete total;
+    for (SparseMatrix* parcela : parcelas) {
+        delete parcela;
+    }
+}
+
+/* Mede expressões encadeadas em matrizes m x m: A + B + C e C += A * B
+ * Compara os operadores, que criam uma matriz a cada operação, com a expressão preguiçosa,
+ * que calcula cada linha do resultado em uma única passada, sem matrizes intermediárias
+ */
+void benchExpressoes(int m, int porLinha) {
+    SparseMatrix* A = gerarAleatoria(m, m, porLinha, 1);
+    SparseMatrix* B = gerarAleatoria(m, m, porLinha, 2);
+    SparseMatrix* C = gerarAleatoria(m, m, porLinha, 3);
+    auto ms = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double, milli>(b - a).count();
+    };
+
+    auto t0 = chrono::steady_clock::now();
+    SparseMatrix soma = *A + *B + *C;
+    auto t1 = chrono::steady_clock::now();
+    SparseMatrix somaFundida = avaliar(expressao(*A) + expressao(*B) + expressao(*C));
+    auto t2 = chrono::steady_clock::now();
+    SparseMatrix produto = *C;
+    produto += *A * *B;
+    auto t3 = chrono::steady_clock::now();
+    SparseMatrix produtoFundido = *C;
+    auto t4 = chrono::steady_clock::now();
+    produtoFundido += expressao(*A) * expressao(*B);
+    auto t5 = chrono::steady_clock::now();
+
+    cout << setw(9) << m << " linhas, " << setw(3) << porLinha << "/linha | " << fixed << setprecision(1)
+         << "A+B+C: " << ms(t0, t1) << " / " << ms(t1, t2) << " ms | "
+         << "C += A*B: " << ms(t2, t3) - ms(t3, t4) << " / " << ms(t4, t5) << " ms (operadores / expressao) | nnz = "
+         << somaFundida.countNonZero() << " / " << soma.countNonZero() << ", "
+         << produtoFundido.countNonZero() << " / " << produto.countNonZero() << "\n";
+
+    delete A;
+    delete B;
+    delete C;
+}
+
+/* Mede a escalabilidade forte de sum e multiply: o mesmo problema com 1, 2, 4, ... threads
+ * Exibe o tempo de cada operação e a aceleração em relação a uma thread
+ */
+void benchScaling(int m, int porLinha) {
+    SparseMatrix* A = gerarAleatoria(m, m, porLinha, 1);
+    SparseMatrix* B = gerarAleatoria(m, m, porLinha, 2);
+
+    int maximo = max(1u, thread::hardware_concurrency());
+    double baseSoma = 0, baseProduto = 0;
+    for (int n = 1; n <= maximo; n = (n * 2 > maximo && n < maximo) ? maximo : n * 2) {
+        setNumThreads(n);
+
+        auto t0 = chrono::steady_clock::now();
+        SparseMatrix* S = sum(A, B);
+        auto t1 = chrono::steady_clock::now();
+        SparseMatrix* C = multiply(A, B);
+        auto t2 = chrono::steady_clock::now();
+
+        double soma = chrono::duration<double, milli>(t1 - t0).count();
+        double produto = chrono::duration<double, milli>(t2 - t1).count();
+        if (n == 1) {
+            baseSoma = soma;
+            baseProduto = produto;
+        }
+        cout << setw(3) << n << " threads | " << fixed << setprecision(1)
+             << "sum: " << soma << " ms (" << setprecision(2) << baseSoma / soma << "x) | "
+             << setprecision(1) << "multiply: " << produto << " ms (" << setprecision(2) << baseProduto / produto << "x)\n";
+
+        delete S;
+        delete C;
+    }
+    setNumThreads(1);
+
+    delete A;
+    delete B;
+}
+
+/* Mede a vazão de leitura com uma thread escrevendo e "leitores" threads lendo a mesma matriz de m x m
+ * Compara a SparseMatrix protegida por uma trava global com a ConcurrentSparseMatrix, cujas leituras não travam
+ * Cada leitura abre um snapshot (ou toma a trava) e faz 64 consultas get, ou um produto matriz-vetor se "spmv"
+ * A escrita grava na versão v da matriz o valor v + 2, acima de todos os valores iniciais (até 1.5); os leitores
+ * da versão concorrente conferem que nenhum valor passa da versão do seu snapshot + 2 e, nos produtos, que
+ * repetir o produto no mesmo snapshot dá o mesmo resultado, enquanto a escrita continua
+ */
+void benchConcorrencia(int m, int porLinha, int leitores, bool spmv, int duracaoMs) {
+    const int CONSULTAS = 64;
+    SparseMatrix* base = gerarAleatoria(m, m, porLinha, 9);
+    vector<double> x(m, 1.0);
+
+    auto executar = [&](auto escrever, auto ler) {
+        atomic<bool> parar{false};
+        atomic<long long> leituras{0};
+        long long escritas = 0;
+        vector<thread> threads;
+        for (int t = 0; t < leitores; ++t) {
+            threads.emplace_back([&, t]() {
+                mt19937 gerador(100 + t);
+                long long total = 0;
+                while (!parar.load(memory_order_relaxed)) {
+                    total += ler(gerador);
+                }
+                leituras += total;
+            });
+        }
+        mt19937 gerador(7);
+        auto inicio = chrono::steady_clock::now();
+        while (chrono::steady_clock::now() - inicio < chrono::milliseconds(duracaoMs)) {
+            escrever(gerador);
+            ++escritas;
+        }
+        parar = true;
+        for (thread& t : threads) {
+            t.join();
+        }
+        double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        return make_pair(leituras.load() / segundos, escritas / segundos);
+    };
+
+    // Referência: toda leitura e toda escrita passam pela mesma trava
+    mutex trava;
+    auto comTrava = executar(
+        [&](mt19937& g) {
+            int i = static_cast<int>(g() % m) + 1, j = static_cast<int>(g() % m) + 1;
+            lock_guard<mutex> t(trava);
+            base->inserir(i, j, 2.0 + (g() % 1000));
+        },
+        [&](mt19937& g) -> long long {
+            lock_guard<mutex> t(trava);
+            if (spmv) {
+                vector<double> y = multiplyVector(base, x);
+                return 1;
+            }
+            double soma = 0;
+            for (int k = 0; k < CONSULTAS; ++k) {
+                soma += base->get(static_cast<int>(g() % m) + 1, static_cast<int>(g() % m) + 1);
+            }
+            return soma >= 0 ? CONSULTAS : 0;
+        });
+
+    delete base;
+    base = gerarAleatoria(m, m, porLinha, 9);
+    ConcurrentSparseMatrix concorrente(*base);
+    delete base;
+
+    atomic<long long> falhas{0};
+    auto semTrava = executar(
+        [&](mt19937& g) {
+            int i = static_cast<int>(g() % m) + 1, j = static_cast<int>(g() % m) + 1;
+            concorrente.inserir(i, j, static_cast<double>(concorrente.versao() + 1 + 2));
+        },
+        [&](mt19937& g) -> long long {
+            ConcurrentSparseMatrix::Snapshot snapshot = concorrente.snapshot();
+            double limite = static_cast<double>(snapshot.versao() + 2);
+            if (spmv) {
+                vector<double> y = snapshot.multiplyVector(x);
+                if (g() % 16 == 0 && snapshot.multiplyVector(x) != y) ++falhas;
+                return 1;
+            }
+            for (int k = 0; k < CONSULTAS; ++k) {
+                if (snapshot.get(static_cast<int>(g() % m) + 1, static_cast<int>(g() % m) + 1) > limite) ++falhas;
+            }
+            return CONSULTAS;
+        });
+
+    double escala = spmv ? 1.0 : 1e6;
+    const char* unidade = spmv ? " produtos/s, " : " M consultas/s, ";
+    cout << setw(3) << leitores << " leitores | " << (spmv ? "spmv | " : "get  | ") << fixed << setprecision(2)
+         << "trava global: " << setw(8) << comTrava.first / escala << unidade
+         << setw(6) << comTrava.second / 1e3 << " k escritas/s"
+         << " | snapshots: " << setw(8) << semTrava.first / escala << unidade
+         << setw(6) << semTrava.second / 1e3 << " k escritas/s"
+         << " | versoes liberadas: " << concorrente.versoesLiberadas()
+         << (falhas.load() == 0 ? "" : " | LEITURAS INCONSISTENTES!") << "\n";
+}
+
+/* Mede a vazão do produto matriz-vetor em GFLOP/s (2 operações por elemento não nulo)
+ * Compara o percurso dos nós da matriz com o núcleo vetorizado sobre a matriz congelada
+ */
+void benchSpmv(int m, int porLinha, int repeticoes) {
+    SparseMatrix* A = gerarAleatoria(m, m, porLinha, 3);
+    vector<double> x(m, 1.0);
+    double flops = 2.0 * A->countNonZero() * repeticoes;
+
+    auto medir = [&]() {
+        double checksum = 0;
+        auto inicio = chrono::steady_clock::now();
+        for (int r = 0; r < repeticoes; ++r) {
+            vector<double> y = multiplyVector(A, x);
+            checksum += y[r % m];
+        }
+        auto fim = chrono::steady_clock::now();
+        return make_pair(flops / chrono::duration<double>(fim - inicio).count() / 1e9, checksum);
+    };
+
+    auto nos = medir();
+    A->freeze();
+    auto csr = medir();
+
+    cout << setw(9) << m << " linhas, " << setw(3) << porLinha << "/linha | " << fixed << setprecision(2)
+         << "nos: " << nos.first << " GFLOP/s | CSR: " << csr.first << " GFLOP/s"
+         << (nos.second == csr.second ? "" : " (resultados diferentes!)") << "\n";
+    delete A;
+}
+
+/* Converte uma matriz CSR para outros tipos de valor e de índice
+ */
+template <typename T, typename Index>
+CSRMatrixT<T, Index> converterCSR(const CSRMatrix& csr) {
+    CSRMatrixT<T, Index> convertida;
+    convertida.linhas = csr.linhas;
+    convertida.colunas = csr.colunas;
+    convertida.row_ptr.assign(csr.row_ptr.begin(), csr.row_ptr.end());
+    convertida.col_idx.assign(csr.col_idx.begin(), csr.col_idx.end());
+    convertida.values.assign(csr.values.begin(), csr.values.end());
+    return convertida;
+}
+
+/* Mede o produto matriz-vetor sobre a forma CSR da mesma matriz com valores e índices de tipos diferentes
+ * Exibe os bytes ocupados pela forma CSR e a vazão em GFLOP/s de cada combinação
+ */
+template <typename T, typename Index>
+void medirPrecisao(const char* nome, const CSRMatrix& base, int repeticoes) {
+    CSRMatrixT<T, Index> csr = converterCSR<T, Index>(base);
+    CSRViewT<T, Index> vista(csr);
+    vector<T> x(csr.colunas, T(1)), y(csr.linhas);
+    double checksum = 0;
+    auto inicio = chrono::steady_clock::now();
+    for (int r = 0; r < repeticoes; ++r) {
+        spmvCSR(vista, x.data(), y.data());
+        checksum += y[r % csr.linhas];
+    }
+    auto fim = chrono::steady_clock::now();
+    double gflops = 2.0 * csr.nnz() * repeticoes / chrono::duration<double>(fim - inicio).count() / 1e9;
+    cout << "  " << left << setw(14) << nome << right << fixed << setprecision(1)
+         << setw(8) << csr.bytes() / (1024.0 * 1024.0) << " MB | " << setprecision(2) << gflops << " GFLOP/s"
+         << " (checksum " << setprecision(0) << checksum << ")\n";
+}
+
+/* Compara o produto matriz-vetor com valores double e float e com índices de 32 e 64 bits
+ */
+void benchPrecisao(int m, int porLinha, int repeticoes) {
+    SparseMatrix* A = gerarAleatoria(m, m, porLinha, 3);
+    CSRMatrix base = A->toCSR();
+    delete A;
+
+    cout << setw(9) << m << " linhas, " << setw(3) << porLinha << "/linha:\n";
+    medirPrecisao<double, int32_t>("double/int32", base, repeticoes);
+    medirPrecisao<float, int32_t>("float/int32", base, repeticoes);
+    medirPrecisao<double, int64_t>("double/int64", base, repeticoes);
+    medirPrecisao<float, int64_t>("float/int64", base, repeticoes);
+}
+
+/* Gera um arquivo no formato dos arquivos 1.txt a 8.txt, com nnz triplas em ordem aleatória
+ */
+void gerarArquivo(const string& nomeArquivo, int m, int nnz) {
+    mt19937 gerador(5);
+    uniform_int_distribution<int> indice(1, m);
+    uniform_int_distribution<int> valor(1, 999);
+
+    ofstream file(nomeArquivo);
+    file << m << " " << m << "\n";
+    for (int k = 0; k < nnz; ++k) {
+        file << indice(gerador) << " " << indice(gerador) << " " << valor(gerador) / 10.0 << "\n";
+    }
+}
+
+/* Carrega o arquivo como a versão original de readSparseMatrix: ifstream e inserir elemento a elemento
+ */
+SparseMatrix* carregarComInserir(const string& nomeArquivo) {
+    ifstream file(nomeArquivo);
+    int linhas, colunas;
+    file >> linhas >> colunas;
+
+    SparseMatrix* m = new SparseMatrix(linhas, colunas);
+    int i, j;
+    double valor;
+    while (file >> i >> j >> valor) {
+        if (valor != 0) {
+            m->inserir(i, j, valor);
+        }
+    }
+    return m;
+}
+
+/* Compara o carregamento de um arquivo de nnz elementos pela inserção elemento a elemento
+ * e pelo carregador em lote (mmap, from_chars, radix sort e montagem linear)
+ */
+void benchLoad(int m, int nnz) {
+    const string nomeArquivo = "benchmark_carga.txt";
+    gerarArquivo(nomeArquivo, m, nnz);
+
+    auto t0 = chrono::steady_clock::now();
+    SparseMatrix* antiga = carregarComInserir(nomeArquivo);
+    auto t1 = chrono::steady_clock::now();
+    SparseMatrix* lote = loadSparseMatrix(nomeArquivo);
+    auto t2 = chrono::steady_clock::now();
+
+    cout << setw(9) << m << " linhas, " << nnz << " triplas | " << fixed << setprecision(1)
+         << "ifstream + inserir: " << chrono::duration<double, milli>(t1 - t0).count() << " ms | "
+         << "em lote: " << chrono::duration<double, milli>(t2 - t1).count() << " ms | nnz = "
+         << lote->countNonZero() << " / " << antiga->countNonZero() << "\n";
+
+    delete antiga;
+    delete lote;
+    remove(nomeArquivo.c_str());
+}
+
+/* Compara a abertura de uma matriz gravada no formato binário com a leitura do arquivo texto equivalente
+ * Mede a abertura sem verificação (só o cabeçalho e o tamanho), com a soma de verificação
+ * e o primeiro produto matriz-vetor, que traz as páginas do arquivo para a memória
+ */
+void benchBinary(int m, int porLinha) {
+    const string nomeTexto = "benchmark_binario.txt";
+    const string nomeBinario = "benchmark_binario.spm";
+    gerarArquivo(nomeTexto, m, m * porLinha);
+    SparseMatrix* original = loadSparseMatrix(nomeTexto);
+
+    auto t0 = chrono::steady_clock::now();
+    saveBinary(original, nomeBinario);
+    auto t1 = chrono::steady_clock::now();
+    SparseMatrix* rapida = openBinary(nomeBinario, false);
+    auto t2 = chrono::steady_clock::now();
+    SparseMatrix* verificada = openBinary(nomeBinario, true);
+    auto t3 = chrono::steady_clock::now();
+    vector<double> y = multiplyVector(rapida, vector<double>(m, 1.0));
+    auto t4 = chrono::steady_clock::now();
+    SparseMatrix* texto = loadSparseMatrix(nomeTexto);
+    auto t5 = chrono::steady_clock::now();
+
+    cout << setw(9) << m << " linhas, " << porLinha << "/linha | " << fixed << setprecision(3)
+         << "gravar: " << chrono::duration<double, milli>(t1 - t0).count() << " ms | "
+         << "abrir: " << chrono::duration<double, milli>(t2 - t1).count() << " ms | "
+         << "abrir verificando: " << chrono::duration<double, milli>(t3 - t2).count() << " ms | "
+         << "1o spmv: " << chrono::duration<double, milli>(t4 - t3).count() << " ms | "
+         << "texto: " << chrono::duration<double, milli>(t5 - t4).count() << " ms (nnz = "
+         << rapida->countNonZero() << " / " << texto->countNonZero() << ")\n";
+
+    // A forma CSC montada sobre o arquivo mapeado pertence à matriz, não ao arquivo: a cópia precisa
+    // continuar válida depois que a matriz de origem for destruída
+    verificada->freeze(true);
+    SparseMatrix copia(*verificada);
+    delete verificada;
+    CSRMatrix esperada = transpor(*copia.getCSR());
+    const CSRView* csc = copia.getCSC();
+    bool cscIgual = csc && equal(esperada.row_ptr.begin(), esperada.row_ptr.end(), csc->row_ptr) &&
+                    equal(esperada.col_idx.begin(), esperada.col_idx.end(), csc->col_idx) &&
+                    equal(esperada.values.begin(), esperada.values.end(), csc->values);
+    cout << setw(31) << "" << "| copia da matriz aberta com CSC: " << (cscIgual ? "ok" : "DIFERENTE") << "\n";
+
+    delete original;
+    delete rapida;
+    delete texto;
+    remove(nomeTexto.c_str());
+    remove(nomeBinario.c_str());
+}
+
+/* Lê um campo de memória de /proc/self/status, em kB (por exemplo "VmRSS" ou "VmHWM")
+ * Retorna -1 se a informação não estiver disponível, como fora do Linux
+ */
+long lerMemoriaKB(const char* campo) {
+    ifstream status("/proc/self/status");
+    string linha;
+    size_t n = strlen(campo);
+    while (getline(status, linha)) {
+        if (linha.compare(0, n, campo) == 0 && linha.size() > n && linha[n] == ':') {
+            return stol(linha.substr(n + 1));
+        }
+    }
+    return -1;
+}
+
+/* Prepara a medição do pico de memória de uma etapa
+ * Devolve ao sistema a memória livre do heap, para que a etapa não reaproveite páginas já contadas,
+ * e zera o pico de memória residente do processo (VmHWM) escrevendo "5" em /proc/self/clear_refs
+ * Retorna a memória residente atual em kB, ou -1 se não for possível zerar o pico
+ */
+long iniciarMedicaoMemoria() {
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+    ofstream limpar("/proc/self/clear_refs");
+    limpar << "5" << flush;
+    if (!limpar) return -1;
+    return lerMemoriaKB("VmRSS");
+}
+
+/* Mede o produto em blocos de duas matrizes m x m gravadas em arquivo, com um orçamento de memória
+ * Grava A e B no formato binário e libera as matrizes antes de medir
+ * Executa multiplyStreaming e confere se o pico de memória residente acrescentado ficou dentro do orçamento
+ * Para comparação, mede também o produto com as duas matrizes e o resultado inteiros na memória
+ */
+void benchStreaming(int m, int porLinha, size_t orcamentoMB) {
+    const string nomeA = "benchmark_a.spm", nomeB = "benchmark_b.spm", nomeC = "benchmark_c.spm";
+    SparseMatrix* A = gerarAleatoria(m, m, porLinha, 1);
+    SparseMatrix* B = gerarAleatoria(m, m, porLinha, 2);
+    A->freeze();
+    B->freeze();
+    saveBinary(A, nomeA);
+    saveBinary(B, nomeB);
+    delete A;
+    delete B;
+
+    long base = iniciarMedicaoMemoria();
+    auto t0 = chrono::steady_clock::now();
+    long long nnz = multiplyStreaming(nomeA, nomeB, nomeC, orcamentoMB << 20);
+    auto t1 = chrono::steady_clock::now();
+    long picoStreaming = lerMemoriaKB("VmHWM") - base;
+
+    base = iniciarMedicaoMemoria();
+    auto t2 = chrono::steady_clock::now();
+    SparseMatrix* memA = openBinary(nomeA);
+    SparseMatrix* memB = openBinary(nomeB);
+    SparseMatrix* C = multiply(memA, memB);
+    auto t3 = chrono::steady_clock::now();
+    long picoMemoria = lerMemoriaKB("VmHWM") - base;
+
+    cout << setw(9) << m << " linhas, " << porLinha << "/linha, nnz(C) = " << nnz << " / " << C->countNonZero() << "\n"
+         << fixed << setprecision(1)
+         << "          em blocos: " << chrono::duration<double, milli>(t1 - t0).count() << " ms";
+    if (base >= 0) {
+        cout << ", pico " << picoStreaming / 1024.0 << " MB de " << orcamentoMB << " MB ("
+             << (static_cast<size_t>(picoStreaming) <= (orcamentoMB << 10) ? "dentro" : "FORA") << " do orcamento)";
+    }
+    cout << "\n          na memoria: " << chrono::duration<double, milli>(t3 - t2).count() << " ms";
+    if (base >= 0) {
+        cout << ", pico " << picoMemoria / 1024.0 << " MB";
+    }
+    cout << "\n";
+
+    delete memA;
+    delete memB;
+    delete C;
+    remove(nomeA.c_str());
+    remove(nomeB.c_str());
+    remove(nomeC.c_str());
+}
+
+// Distribuições dos elementos nas matrizes sintéticas da bateria --json
+enum class Distribuicao { Uniforme, PotenciaLei, Faixa, BlocoDiagonal };
+
+// Nome de cada distribuição nos resultados
+const char* nomeDistribuicao(Distribuicao d) {
+    switch (d) {
+        case Distribuicao::Uniforme: return "uniforme";
+        case Distribuicao::PotenciaLei: return "potencia";
+        case Distribuicao::Faixa: return "faixa";
+        case Distribuicao::BlocoDiagonal: return "bloco_diagonal";
+    }
+    return "";
+}
+
+/* Gera as triplas de uma matriz m x m com cerca de porLinha elementos por linha, na ordem das linhas
+ * A semente fixa faz com que a mesma matriz seja gerada em todas as execuções e máquinas
+ * Uniforme: porLinha colunas sorteadas em cada linha
+ * Potência: o tamanho de cada linha segue uma lei de potência (Pareto com expoente 2 e média porLinha),
+ *   com poucas linhas muito longas, como nas matrizes de grafos reais; as colunas são sorteadas
+ * Faixa: as porLinha colunas em torno da diagonal, como nas discretizações de equações diferenciais
+ * Bloco diagonal: blocos densos de porLinha x porLinha ao longo da diagonal
+ * Posições repetidas ficam para buildCSR e inserir, que mantêm o último valor
+ */
+vector<Tripla> gerarTriplas(Distribuicao distribuicao, int m, int porLinha, unsigned semente) {
+    mt19937 gerador(semente);
+    uniform_int_distribution<int> coluna(1, m);
+    uniform_real_distribution<double> valor(0.5, 1.5);
+    uniform_real_distribution<double> uniforme(0.0, 1.0);
+
+    vector<Tripla> triplas;
+    triplas.reserve(static_cast<size_t>(m) * porLinha);
+    for (int i = 1; i <= m; ++i) {
+        switch (distribuicao) {
+            case Distribuicao::Uniforme:
+                for (int k = 0; k < porLinha; ++k) {
+                    triplas.push_back({i, coluna(gerador), valor(gerador)});
+                }
+                break;
+            case Distribuicao::PotenciaLei: {
+                double tamanho = 0.5 * porLinha / sqrt(1.0 - uniforme(gerador));
+                int n = static_cast<int>(min<double>(m, max(1.0, tamanho)));
+                for (int k = 0; k < n; ++k) {
+                    triplas.push_back({i, coluna(gerador), valor(gerador)});
+                }
+                break;
+            }
+            case Distribuicao::Faixa: {
+                int inicio = max(1, min(m - porLinha + 1, i - porLinha / 2));
+                for (int j = inicio; j < inicio + porLinha && j <= m; ++j) {
+                    triplas.push_back({i, j, valor(gerador)});
+                }
+                break;
+            }
+            case Distribuicao::BlocoDiagonal: {
+                int inicio = (i - 1) / porLinha * porLinha + 1;
+                for (int j = inicio; j < inicio + porLinha && j <= m; ++j) {
+                    triplas.push_back({i, j, valor(gerador)});
+                }
+                break;
+            }
+        }
+    }
+    return triplas;
+}
+
+// Resultado de uma operação da bateria: menor tempo entre as repetições
+struct ResultadoBench {
+    string distribuicao, operacao;
+    long long nnz;          // Elementos não nulos da matriz usada
+    long long operacoes;    // Operações elementares medidas (inserções, consultas) ou 1
+    double ms;
+};
+
+/* Roda a bateria de operações sobre uma matriz sintética da distribuição escolhida
+ * Mede inserir (elemento a elemento, na ordem das linhas), get (metade das consultas em posições ocupadas,
+ * metade em posições sorteadas), countNonZero, sum e multiply com uma segunda matriz da mesma distribuição,
+ * clear, a carga de um arquivo texto com loadSparseMatrix e o destrutor da matriz carregada
+ * Repete a sequência inteira e guarda o menor tempo de cada operação, que é o menos afetado por ruído
+ */
+void benchSuite(Distribuicao distribuicao, int m, int porLinha, int repeticoes, vector<ResultadoBench>& resultados) {
+    vector<Tripla> triplasA = gerarTriplas(distribuicao, m, porLinha, 1);
+    vector<Tripla> triplasB = gerarTriplas(distribuicao, m, porLinha, 2);
+    vector<Tripla> copia = triplasB;
+    CSRMatrix csrB = buildCSR(m, m, copia);
+
+    mt19937 gerador(3);
+    uniform_int_distribution<int> indice(1, m);
+    vector<pair<int, int>> consultas;
+    for (size_t k = 0; k < triplasA.size(); ++k) {
+        if (k % 2 == 0) consultas.push_back({triplasA[k].linha, triplasA[k].coluna});
+        else consultas.push_back({indice(gerador), indice(gerador)});
+    }
+
+    const string nomeArquivo = "benchmark_suite.txt";
+    map<string, ResultadoBench> melhores;
+    vector<string> ordem;
+    long long nnzA = 0;
+    double soma = 0;
+
+    for (int r = 0; r < repeticoes; ++r) {
+        auto registrar = [&](const string& operacao, long long operacoes, chrono::steady_clock::time_point a,
+                             chrono::steady_clock::time_point b) {
+            double ms = chrono::duration<double, milli>(b - a).count();
+            auto it = melhores.find(operacao);
+            if (it == melhores.end()) {
+                ordem.push_back(operacao);
+                melhores[operacao] = {nomeDistribuicao(distribuicao), operacao, 0, operacoes, ms};
+            } else {
+                it->second.ms = min(it->second.ms, ms);
+            }
+        };
+
+        SparseMatrix* A = new SparseMatrix(m, m);
+        auto t0 = chrono::steady_clock::now();
+        for (const Tripla& t : triplasA) {
+            A->inserir(t.linha, t.coluna, t.valor);
+        }
+        auto t1 = chrono::steady_clock::now();
+        registrar("inserir", static_cast<long long>(triplasA.size()), t0, t1);
+
+        t0 = chrono::steady_clock::now();
+        for (const pair<int, int>& c : consultas) {
+            soma += A->get(c.first, c.second);
+        }
+        t1 = chrono::steady_clock::now();
+        registrar("get", static_cast<long long>(consultas.size()), t0, t1);
+
+        t0 = chrono::steady_clock::now();
+        nnzA = A->countNonZero();
+        t1 = chrono::steady_clock::now();
+        registrar("countNonZero", 1, t0, t1);
+
+        SparseMatrix* B = new SparseMatrix(csrB);
+        t0 = chrono::steady_clock::now();
+        SparseMatrix* S = sum(A, B);
+        t1 = chrono::steady_clock::now();
+        registrar("sum", 1, t0, t1);
+        delete S;
+
+        t0 = chrono::steady_clock::now();
+        SparseMatrix* C = multiply(A, B);
+        t1 = chrono::steady_clock::now();
+        registrar("multiply", 1, t0, t1);
+        delete C;
+        delete B;
+
+        saveSparseMatrix(A, nomeArquivo, FormatoTexto::Triplas);
+        t0 = chrono::steady_clock::now();
+        A->clear();
+        t1 = chrono::steady_clock::now();
+        registrar("clear", 1, t0, t1);
+        delete A;
+
+        t0 = chrono::steady_clock::now();
+        SparseMatrix* L = loadSparseMatrix(nomeArquivo);
+        t1 = chrono::steady_clock::now();
+        registrar("load", 1, t0, t1);
+
+        t0 = chrono::steady_clock::now();
+        delete L;
+        t1 = chrono::steady_clock::now();
+        registrar("destrutor", 1, t0, t1);
+    }
+    remove(nomeArquivo.c_str());
+
+    for (const string& operacao : ordem) {
+        melhores[operacao].nnz = nnzA;
+        resultados.push_back(melhores[operacao]);
+    }
+    cerr << nomeDistribuicao(distribuicao) << ": nnz = " << nnzA << " (checksum " << soma << ")\n";
+}
+
+/* Grava os resultados da bateria em JSON: os parâmetros da execução e uma entrada por operação,
+ * com o tempo em milissegundos e, nas operações elemento a elemento, a vazão em operações por segundo
+ */
+void gravarJSON(ostream& saida, int m, int porLinha, int repeticoes, const vector<ResultadoBench>& resultados) {
+    saida << "{\n"
+          << "  \"linhas\": " << m << ",\n"
+          << "  \"porLinha\": " << porLinha << ",\n"
+          << "  \"repeticoes\": " << repeticoes << ",\n"
+          << "  \"threads\": " << getNumThreads() << ",\n"
+          << "  \"resultados\": [\n";
+    saida << setprecision(6) << defaultfloat;
+    for (size_t k = 0; k < resultados.size(); ++k) {
+        const ResultadoBench& r = resultados[k];
+        saida << "    {\"distribuicao\": \"" << r.distribuicao << "\", \"operacao\": \"" << r.operacao
+              << "\", \"nnz\": " << r.nnz << ", \"ms\": " << r.ms;
+        if (r.operacoes > 1) {
+            saida << ", \"operacoes\": " << r.operacoes << ", \"ops_por_s\": " << r.operacoes / (r.ms / 1000.0);
+        }
+        saida << "}" << (k + 1 < resultados.size() ? "," : "") << "\n";
+    }
+    saida << "  ]\n}\n";
+}
+
+/* Interpreta os argumentos de --json e roda a bateria com as quatro distribuições
+ * Grava o JSON no arquivo informado logo após --json, ou na saída padrão; o progresso vai para a saída de erro
+ */
+int executarSuite(int argc, char** argv) {
+    int m = 100000, porLinha = 8, repeticoes = 3;
+    string nomeSaida;
+    for (int k = 1; k < argc; ++k) {
+        string arg = argv[k];
+        if (arg == "--json" && k + 1 < argc && strncmp(argv[k + 1], "--", 2) != 0) {
+            nomeSaida = argv[++k];
+        } else if (arg == "--linhas" && k + 1 < argc) {
+            m = atoi(argv[++k]);
+        } else if (arg == "--porLinha" && k + 1 < argc) {
+            porLinha = atoi(argv[++k]);
+        } else if (arg == "--repeticoes" && k + 1 < argc) {
+            repeticoes = atoi(argv[++k]);
+        } else if (arg != "--json") {
+            cerr << "Argumento invalido: " << arg << "\n";
+            return 1;
+        }
+    }
+    if (m <= 0 || porLinha <= 0 || porLinha > m || repeticoes <= 0) {
+        cerr << "Parametros invalidos.\n";
+        return 1;
+    }
+
+    vector<ResultadoBench> resultados;
+    for (Distribuicao d : {Distribuicao::Uniforme, Distribuicao::PotenciaLei, Distribuicao::Faixa,
+                           Distribuicao::BlocoDiagonal}) {
+        benchSuite(d, m, porLinha, repeticoes, resultados);
+    }
+
+    if (nomeSaida.empty()) {
+        gravarJSON(cout, m, porLinha, repeticoes, resultados);
+    } else {
+        ofstream file(nomeSaida);
+        gravarJSON(file, m, porLinha, repeticoes, resultados);
+        if (!file) {
+            cerr << "Erro ao gravar o arquivo " << nomeSaida << ".\n";
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        return executarSuite(argc, argv);
+    }
+
+    cout << "Acesso aleatorio (inserir/get):\n";
+    for (int m : {100000, 300000, 1000000}) {
+        benchRandomAccess(m, 20000);
+    }
+
+    cout << "\nCarga e destruicao:\n";
+    benchLoadTeardown(1000000, 4);
+    benchLoadTeardown(100000, 40);
+
+    cout << "\nAcumulo de somas:\n";
+    benchAccumulate(10000, 2, 100);
+    benchAccumulate(10000, 20, 10);
+
+    cout << "\nMultiplicacao:\n";
+    for (int porLinha : {4, 16, 32}) {
+        benchMultiply(10000, porLinha);
+    }
+    for (int porLinha : {2, 4, 8}) {
+        benchMultiply(100000, porLinha);
+    }
+
+    cout << "\nMultiplicacao de matrizes em blocos:\n";
+    benchBlocos(20000, 8, 4, 0.9);
+    benchBlocos(20000, 4, 8, 0.9);
+    benchBlocos(20000, 8, 4, 0.2);
+
+    cout << "\nProdutos A^T * A e A * A^T:\n";
+    benchGram(20000, 8);
+    benchGram(5000, 16);
+
+    cout << "\nExpressoes encadeadas:\n";
+    benchExpressoes(100000, 4);
+    benchExpressoes(10000, 32);
+
+    cout << "\nProduto matriz-vetor:\n";
+    benchSpmv(100000, 8, 50);
+    benchSpmv(100000, 64, 10);
+    benchSpmv(1000000, 8, 5);
+
+    cout << "\nProduto matriz-vetor por tipo de valor e de indice:\n";
+    benchPrecisao(1000000, 16, 20);
+
+    cout << "\nCarga de arquivo:\n";
+    benchLoad(1000000, 10000000);
+
+    cout << "\nFormato binario:\n";
+    benchBinary(100000, 8);
+    benchBinary(1000000, 8);
+
+    cout << "\nProduto em blocos com orcamento de memoria:\n";
+    benchStreaming(200000, 8, 64);
+    benchStreaming(200000, 8, 32);
+
+    cout << "\nEscalabilidade (100000 linhas, 8/linha):\n";
+    benchScaling(100000, 8);
+
+    cout << "\nLeitura concorrente com uma escrita (100000 linhas, 8/linha):\n";
+    int maximo = max(2u, thread::hardware_concurrency());
+    for (int leitores = 1; leitores < maximo; leitores *= 2) {
+        benchConcorrencia(100000, 8, leitores, false, 500);
+    }
+    for (int leitores = 1; leitores < maximo; leitores *= 2) {
+        benchConcorrencia(100000, 8, leitores, true, 500);
+    }
+    return 0;
+}
@@ -0,0 +1,344 @@
+#include "binary_format.h"
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+static const char MAGICA_BINARIA[4] = {'S', 'P', 'M', 'X'};
+static const uint32_t VERSAO_BINARIA = 1;
+static const uint32_t ORDEM_BYTES = 0x01020304;
+static const uint64_t CHECKSUM_INICIAL = 0xcbf29ce484222325ULL;
+
+// Quantidade de posições de row_ptr que o escritor acumula antes de gravá-las
+static const size_t BUFFER_ROW_PTR = 4096;
+
+// Tamanho dos trechos lidos de volta do arquivo para calcular a soma de verificação (múltiplo de 8)
+static const size_t TRECHO_CHECKSUM = 1 << 16;
+
+static_assert(sizeof(CabecalhoBinario) == 48 && sizeof(int) == sizeof(int32_t), "Layout binario inesperado");
+
+/* Cria o cabeçalho de uma matriz com as dimensões informadas
+ * A soma de verificação fica zerada, para ser preenchida depois
+ */
+CabecalhoBinario CabecalhoBinario::criar(int64_t linhas, int64_t colunas, int64_t nnz) {
+    CabecalhoBinario cabecalho;
+    memcpy(cabecalho.magica, MAGICA_BINARIA, sizeof(MAGICA_BINARIA));
+    cabecalho.versao = VERSAO_BINARIA;
+    cabecalho.ordemBytes = ORDEM_BYTES;
+    cabecalho.reservado = 0;
+    cabecalho.linhas = linhas;
+    cabecalho.colunas = colunas;
+    cabecalho.nnz = nnz;
+    cabecalho.checksum = 0;
+    return cabecalho;
+}
+
+/* Lê o cabeçalho no início de um arquivo e confere os seus campos
+ * Confere a identificação, a versão, a ordem de bytes e os limites das dimensões
+ * Confere se o tamanho do arquivo corresponde exatamente às dimensões, detectando arquivos truncados
+ * Lança uma exceção se alguma das conferências falhar
+ */
+CabecalhoBinario CabecalhoBinario::ler(const char* dados, size_t tamanho) {
+    CabecalhoBinario cabecalho;
+    if (tamanho < sizeof(cabecalho)) {
+        throw runtime_error("Erro: Arquivo binario truncado.");
+    }
+    memcpy(&cabecalho, dados, sizeof(cabecalho));
+    if (memcmp(cabecalho.magica, MAGICA_BINARIA, sizeof(MAGICA_BINARIA)) != 0 ||
+        cabecalho.versao != VERSAO_BINARIA || cabecalho.ordemBytes != ORDEM_BYTES) {
+        throw runtime_error("Erro: O arquivo nao esta no formato binario de matrizes.");
+    }
+    if (cabecalho.linhas <= 0 || cabecalho.linhas >= INT_MAX || cabecalho.colunas <= 0 || cabecalho.colunas > INT_MAX ||
+        cabecalho.nnz < 0 || cabecalho.nnz > INT_MAX) {
+        throw runtime_error("Erro: Dimensoes invalidas no arquivo.");
+    }
+    if (tamanho != LayoutBinario(cabecalho.linhas, cabecalho.nnz).tamanho) {
+        throw runtime_error("Erro: Arquivo binario truncado.");
+    }
+    return cabecalho;
+}
+
+// Calcula a posição de cada vetor no arquivo; values começa em um múltiplo de 8 bytes
+LayoutBinario::LayoutBinario(int64_t linhas, int64_t nnz) {
+    rowPtr = sizeof(CabecalhoBinario);
+    colIdx = rowPtr + static_cast<size_t>(linhas + 1) * sizeof(int32_t);
+    values = (colIdx + static_cast<size_t>(nnz) * sizeof(int32_t) + 7) / 8 * 8;
+    tamanho = values + static_cast<size_t>(nnz) * sizeof(double);
+}
+
+/* Acumula na soma de verificação os bytes de um trecho de memória
+ * Usa a mistura do FNV-1a, mas sobre palavras de 8 bytes, para que a verificação
+ * acompanhe a velocidade de leitura do arquivo; os bytes finais são misturados um a um
+ * Um vetor pode ser acumulado em vários trechos, desde que todos menos o último tenham múltiplos de 8 bytes
+ */
+static uint64_t acumularChecksum(uint64_t h, const void* dados, size_t n) {
+    const uint64_t PRIMO = 0x100000001b3ULL;
+    const char* p = static_cast<const char*>(dados);
+    size_t k = 0;
+    for (; k + 8 <= n; k += 8) {
+        uint64_t palavra;
+        memcpy(&palavra, p + k, 8);
+        h = (h ^ palavra) * PRIMO;
+    }
+    for (; k < n; ++k) {
+        h = (h ^ static_cast<unsigned char>(p[k])) * PRIMO;
+    }
+    return h;
+}
+
+// Inicia a soma de verificação com o cabeçalho, considerando o seu campo checksum zerado
+static uint64_t checksumCabecalho(CabecalhoBinario cabecalho) {
+    cabecalho.checksum = 0;
+    return acumularChecksum(CHECKSUM_INICIAL, &cabecalho, sizeof(cabecalho));
+}
+
+// Calcula a soma de verificação do cabeçalho e dos vetores de uma matriz CSR
+uint64_t calcularChecksum(const CabecalhoBinario& cabecalho, const CSRView& csr) {
+    uint64_t h = checksumCabecalho(cabecalho);
+    h = acumularChecksum(h, csr.row_ptr, static_cast<size_t>(csr.linhas + 1) * sizeof(int32_t));
+    h = acumularChecksum(h, csr.col_idx, static_cast<size_t>(csr.nnz()) * sizeof(int32_t));
+    h = acumularChecksum(h, csr.values, static_cast<size_t>(csr.nnz()) * sizeof(double));
+    return h;
+}
+
+/* Acumula na soma de verificação um vetor gravado no arquivo, lendo-o em trechos de tamanho fixo
+ */
+static uint64_t acumularChecksumArquivo(uint64_t h, fstream& file, size_t inicio, size_t n, vector<char>& trecho) {
+    file.seekg(static_cast<streamoff>(inicio));
+    while (n > 0) {
+        size_t lidos = min(n, trecho.size());
+        file.read(trecho.data(), static_cast<streamsize>(lidos));
+        h = acumularChecksum(h, trecho.data(), lidos);
+        n -= lidos;
+    }
+    return h;
+}
+
+/* Abre o arquivo e lê o seu cabeçalho
+ * Obtém o tamanho do arquivo pela posição do final, para conferir o cabeçalho sem lê-lo inteiro
+ */
+static CabecalhoBinario lerCabecalhoArquivo(ifstream& file) {
+    if (!file.is_open()) {
+        throw runtime_error("Erro ao abrir o arquivo.");
+    }
+    file.seekg(0, ios::end);
+    size_t tamanho = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+
+    char dados[sizeof(CabecalhoBinario)] = {};
+    file.read(dados, static_cast<streamsize>(min(tamanho, sizeof(dados))));
+    return CabecalhoBinario::ler(dados, tamanho);
+}
+
+/* Abre o arquivo para leitura em blocos
+ * Lê e confere o cabeçalho; os vetores só são lidos bloco a bloco
+ * Reserva os buffers do bloco com a capacidade informada, que não cresce durante a leitura
+ */
+LeitorBinario::LeitorBinario(const string& nomeArquivo, int capacidade)
+    : m_file(nomeArquivo, ios::binary), m_cabecalho(lerCabecalhoArquivo(m_file)),
+      m_layout(m_cabecalho.linhas, m_cabecalho.nnz), m_capacidade(capacidade), m_inicio(1), m_fim(1) {
+    if (capacidade < 1) {
+        throw invalid_argument("Erro: Capacidade invalida para a leitura em blocos.");
+    }
+    m_rowPtr.reserve(capacidade + 1);
+    m_cols.reserve(capacidade);
+    m_valores.reserve(capacidade);
+}
+
+/* Carrega o próximo bloco de linhas
+ * Lê as posições de row_ptr de até "capacidade" linhas a partir da primeira ainda não lida
+ * Mantém no bloco o maior número de linhas cujos elementos caibam na capacidade
+ * Lê as colunas e os valores dessas linhas, cada vetor de uma só vez
+ * Confere row_ptr e as colunas lidas, lançando uma exceção se o arquivo estiver corrompido
+ */
+bool LeitorBinario::proximoBloco() {
+    int linhas = getLinhas();
+    if (m_fim > linhas) return false;
+    m_inicio = m_fim;
+
+    int quantidade = min(m_capacidade, linhas - m_inicio + 1);
+    m_rowPtr.resize(quantidade + 1);
+    m_file.seekg(static_cast<streamoff>(m_layout.rowPtr + static_cast<size_t>(m_inicio - 1) * sizeof(int32_t)));
+    m_file.read(reinterpret_cast<char*>(m_rowPtr.data()), static_cast<streamsize>((quantidade + 1) * sizeof(int32_t)));
+    if (!m_file) {
+        throw runtime_error("Erro: Arquivo binario truncado.");
+    }
+
+    int n = 0;
+    while (n < quantidade && m_rowPtr[n + 1] >= m_rowPtr[n] &&
+           static_cast<int64_t>(m_rowPtr[n + 1]) - m_rowPtr[0] <= m_capacidade) {
+        ++n;
+    }
+    if (n == 0) {
+        if (m_rowPtr[1] < m_rowPtr[0]) {
+            throw runtime_error("Erro: Arquivo binario corrompido.");
+        }
+        throw runtime_error("Erro: Uma linha da matriz nao cabe no bloco de leitura.");
+    }
+    if (m_rowPtr[0] < 0 || m_rowPtr[n] > m_cabecalho.nnz) {
+        throw runtime_error("Erro: Arquivo binario corrompido.");
+    }
+    m_rowPtr.resize(n + 1);
+    m_fim = m_inicio + n;
+
+    size_t elementos = static_cast<size_t>(m_rowPtr[n] - m_rowPtr[0]);
+    m_cols.resize(elementos);
+    m_valores.resize(elementos);
+    m_file.seekg(static_cast<streamoff>(m_layout.colIdx + static_cast<size_t>(m_rowPtr[0]) * sizeof(int32_t)));
+    m_file.read(reinterpret_cast<char*>(m_cols.data()), static_cast<streamsize>(elementos * sizeof(int32_t)));
+    m_file.seekg(static_cast<streamoff>(m_layout.values + static_cast<size_t>(m_rowPtr[0]) * sizeof(double)));
+    m_file.read(reinterpret_cast<char*>(m_valores.data()), static_cast<streamsize>(elementos * sizeof(double)));
+    if (!m_file) {
+        throw runtime_error("Erro: Arquivo binario truncado.");
+    }
+
+    for (int j : m_cols) {
+        if (j < 1 || j > getColunas()) {
+            throw runtime_error("Erro: Arquivo binario corrompido.");
+        }
+    }
+    return true;
+}
+
+/* Cria o arquivo de saída e o arquivo temporário dos valores
+ * Reserva o espaço do cabeçalho, que só é gravado em finalizar, e guarda a primeira posição de row_ptr
+ */
+EscritorBinario::EscritorBinario(const string& nomeArquivo, int linhas, int colunas, int capacidade)
+    : m_file(nomeArquivo, ios::binary | ios::in | ios::out | ios::trunc), m_nomeTemporario(nomeArquivo + ".valores.tmp"),
+      m_linhas(linhas), m_colunas(colunas), m_capacidade(capacidade), m_linhasGravadas(0), m_nnz(0), m_descarregados(0) {
+    if (!m_file.is_open()) {
+        throw runtime_error("Erro ao abrir o arquivo.");
+    }
+    if (linhas <= 0 || colunas <= 0) {
+        throw invalid_argument("Erro: Dimensoes invalidas! Linhas e colunas devem ser maiores que zero.");
+    }
+    if (capacidade < 1) {
+        throw invalid_argument("Erro: Capacidade invalida para a gravacao em blocos.");
+    }
+    m_temporario.open(m_nomeTemporario, ios::binary | ios::in | ios::out | ios::trunc);
+    if (!m_temporario.is_open()) {
+        throw runtime_error("Erro ao abrir o arquivo.");
+    }
+
+    CabecalhoBinario vazio = CabecalhoBinario::criar(0, 0, 0);
+    m_file.write(reinterpret_cast<const char*>(&vazio), sizeof(vazio));
+    m_rowPtr.reserve(BUFFER_ROW_PTR);
+    m_rowPtr.push_back(0);
+    m_cols.reserve(capacidade);
+    m_valores.reserve(capacidade);
+}
+
+// Fecha e remove o arquivo temporário, se ele ainda existir
+EscritorBinario::~EscritorBinario() {
+    if (m_temporario.is_open()) {
+        m_temporario.close();
+        remove(m_nomeTemporario.c_str());
+    }
+}
+
+/* Acrescenta a próxima linha aos buffers
+ * Confere as colunas e descarta os valores nulos, como inserirLinha
+ * Descarrega os buffers sempre que algum deles enche; uma linha maior que a capacidade é gravada em partes
+ * Lança uma exceção se todas as linhas já tiverem sido gravadas ou se nnz passar do limite do formato
+ */
+void EscritorBinario::gravarLinha(const int* cols, const double* valores, int n) {
+    if (m_linhasGravadas == m_linhas) {
+        throw logic_error("Erro: Todas as linhas ja foram gravadas.");
+    }
+
+    int coluna_anterior = 0;
+    for (int k = 0; k < n; ++k) {
+        if (cols[k] <= coluna_anterior || cols[k] > m_colunas) {
+            throw out_of_range("Erro: Colunas fora dos limites ou fora de ordem.");
+        }
+        coluna_anterior = cols[k];
+        if (valores[k] == 0) continue;
+
+        if (m_nnz == INT_MAX) {
+            throw runtime_error("Erro: A matriz tem elementos demais para o formato binario.");
+        }
+        if (static_cast<int>(m_cols.size()) == m_capacidade) {
+            descarregar();
+        }
+        m_cols.push_back(cols[k]);
+        m_valores.push_back(valores[k]);
+        m_nnz++;
+    }
+
+    m_linhasGravadas++;
+    m_rowPtr.push_back(static_cast<int>(m_nnz));
+    if (m_rowPtr.size() == BUFFER_ROW_PTR) {
+        descarregar();
+    }
+}
+
+/* Grava o conteúdo dos buffers
+ * row_ptr e col_idx começam em posições fixas do arquivo, por isso vão direto para o lugar definitivo;
+ * os valores são acrescentados ao arquivo temporário
+ */
+void EscritorBinario::descarregar() {
+    LayoutBinario layout(m_linhas, 0);
+    size_t gravadasAntes = static_cast<size_t>(m_linhasGravadas + 1) - m_rowPtr.size();
+    m_file.seekp(static_cast<streamoff>(layout.rowPtr + gravadasAntes * sizeof(int32_t)));
+    m_file.write(reinterpret_cast<const char*>(m_rowPtr.data()), static_cast<streamsize>(m_rowPtr.size() * sizeof(int32_t)));
+    m_file.seekp(static_cast<streamoff>(layout.colIdx + static_cast<size_t>(m_descarregados) * sizeof(int32_t)));
+    m_file.write(reinterpret_cast<const char*>(m_cols.data()), static_cast<streamsize>(m_cols.size() * sizeof(int32_t)));
+    m_temporario.write(reinterpret_cast<const char*>(m_valores.data()), static_cast<streamsize>(m_valores.size() * sizeof(double)));
+
+    m_descarregados += static_cast<int64_t>(m_cols.size());
+    m_rowPtr.clear();
+    m_cols.clear();
+    m_valores.clear();
+}
+
+/* Completa o arquivo
+ * Confere se todas as linhas foram gravadas e descarrega os buffers
+ * Preenche com zeros o espaço entre col_idx e values e copia os valores do arquivo temporário
+ * para a sua posição definitiva, em trechos de tamanho fixo, removendo o temporário ao final
+ * Lê de volta os vetores, também em trechos, para calcular a soma de verificação
+ * Grava o cabeçalho definitivo e lança uma exceção se alguma escrita tiver falhado
+ */
+void EscritorBinario::finalizar() {
+    if (m_linhasGravadas != m_linhas) {
+        throw logic_error("Erro: Nem todas as linhas foram gravadas.");
+    }
+    descarregar();
+
+    LayoutBinario layout(m_linhas, m_nnz);
+    size_t fimColIdx = layout.colIdx + static_cast<size_t>(m_nnz) * sizeof(int32_t);
+    const char zeros[8] = {};
+    m_file.seekp(static_cast<streamoff>(fimColIdx));
+    m_file.write(zeros, static_cast<streamsize>(layout.values - fimColIdx));
+
+    vector<char> trecho(TRECHO_CHECKSUM);
+    size_t restante = static_cast<size_t>(m_nnz) * sizeof(double);
+    m_temporario.seekg(0);
+    while (restante > 0) {
+        size_t n = min(restante, trecho.size());
+        m_temporario.read(trecho.data(), static_cast<streamsize>(n));
+        m_file.write(trecho.data(), static_cast<streamsize>(n));
+        restante -= n;
+    }
+    if (!m_temporario) {
+        throw runtime_error("Erro ao gravar o arquivo.");
+    }
+    m_temporario.close();
+    remove(m_nomeTemporario.c_str());
+    m_file.flush();
+
+    CabecalhoBinario cabecalho = CabecalhoBinario::criar(m_linhas, m_colunas, m_nnz);
+    uint64_t h = checksumCabecalho(cabecalho);
+    h = acumularChecksumArquivo(h, m_file, layout.rowPtr, layout.colIdx - layout.rowPtr, trecho);
+    h = acumularChecksumArquivo(h, m_file, layout.colIdx, static_cast<size_t>(m_nnz) * sizeof(int32_t), trecho);
+    h = acumularChecksumArquivo(h, m_file, layout.values, static_cast<size_t>(m_nnz) * sizeof(double), trecho);
+    cabecalho.checksum = h;
+
+    m_file.seekp(0);
+    m_file.write(reinterpret_cast<const char*>(&cabecalho), sizeof(cabecalho));
+    m_file.flush();
+    if (!m_file) {
+        throw runtime_error("Erro ao gravar o arquivo.");
+    }
+}
@@ -0,0 +1,113 @@
+#ifndef BINARY_FORMAT_H
+#define BINARY_FORMAT_H
+
+#include "csr_matrix.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Cabeçalho do formato binário de matrizes, gravado no início do arquivo (48 bytes)
+// Em seguida vêm row_ptr (linhas + 1 inteiros de 32 bits), col_idx (nnz inteiros de 32 bits),
+// zeros até o próximo múltiplo de 8 bytes e values (nnz doubles), todos na ordem de bytes da máquina
+struct CabecalhoBinario {
+    char magica[4];       // "SPMX"
+    uint32_t versao;      // Versão do formato
+    uint32_t ordemBytes;  // Marca fixa, para recusar arquivos gravados com outra ordem de bytes
+    uint32_t reservado;   // Zero
+    int64_t linhas, colunas, nnz;
+    uint64_t checksum;    // Soma de verificação do cabeçalho (com este campo zerado) e dos vetores
+
+    // Cria o cabeçalho de uma matriz com as dimensões informadas, com a soma de verificação zerada
+    static CabecalhoBinario criar(int64_t linhas, int64_t colunas, int64_t nnz);
+
+    // Lê e confere o cabeçalho no início de um arquivo de "tamanho" bytes, lançando uma exceção se for inválido
+    // Confere também se o tamanho do arquivo corresponde às dimensões, o que detecta arquivos truncados
+    static CabecalhoBinario ler(const char* dados, std::size_t tamanho);
+};
+
+// Posição, em bytes a partir do início do arquivo, de cada vetor de uma matriz com as dimensões informadas
+struct LayoutBinario {
+    std::size_t rowPtr, colIdx, values, tamanho;
+
+    LayoutBinario(int64_t linhas, int64_t nnz);
+};
+
+// Calcula a soma de verificação de uma matriz CSR com o cabeçalho informado
+uint64_t calcularChecksum(const CabecalhoBinario& cabecalho, const CSRView& csr);
+
+// Lê em blocos as linhas de uma matriz gravada no formato binário, de cima para baixo,
+// mantendo na memória no máximo "capacidade" elementos (e capacidade + 1 posições de row_ptr) por vez
+class LeitorBinario {
+public:
+    // Abre o arquivo e lê o cabeçalho, lançando uma exceção se não for possível
+    LeitorBinario(const std::string& nomeArquivo, int capacidade);
+
+    // Retorna as dimensões da matriz
+    int getLinhas() const { return static_cast<int>(m_cabecalho.linhas); }
+    int getColunas() const { return static_cast<int>(m_cabecalho.colunas); }
+
+    // Carrega o próximo bloco de linhas; retorna falso se todas as linhas já foram lidas
+    // Lança uma exceção se uma linha sozinha não couber na capacidade ou se o arquivo estiver corrompido
+    bool proximoBloco();
+
+    // Linhas do bloco atual: [inicioBloco(), fimBloco())
+    int inicioBloco() const { return m_inicio; }
+    int fimBloco() const { return m_fim; }
+
+    // Colunas, valores e quantidade de elementos da linha i do bloco atual
+    const int* colunasLinha(int i) const { return m_cols.data() + (m_rowPtr[i - m_inicio] - m_rowPtr[0]); }
+    const double* valoresLinha(int i) const { return m_valores.data() + (m_rowPtr[i - m_inicio] - m_rowPtr[0]); }
+    int tamanhoLinha(int i) const { return m_rowPtr[i - m_inicio + 1] - m_rowPtr[i - m_inicio]; }
+
+private:
+    std::ifstream m_file;
+    CabecalhoBinario m_cabecalho;
+    LayoutBinario m_layout;
+    int m_capacidade;
+    int m_inicio, m_fim;         // Linhas do bloco atual
+    std::vector<int> m_rowPtr;   // row_ptr das linhas do bloco, mais a seguinte
+    std::vector<int> m_cols;
+    std::vector<double> m_valores;
+};
+
+// Grava no formato binário uma matriz produzida linha a linha, de cima para baixo, sem mantê-la inteira na memória
+// Guarda no máximo "capacidade" elementos antes de gravá-los; como nnz só é conhecido ao final,
+// os valores passam por um arquivo temporário e são copiados para a posição definitiva em finalizar
+class EscritorBinario {
+public:
+    // Cria o arquivo e o arquivo temporário dos valores, lançando uma exceção se não for possível
+    EscritorBinario(const std::string& nomeArquivo, int linhas, int colunas, int capacidade);
+
+    // Remove o arquivo temporário, caso finalizar não tenha sido chamada
+    ~EscritorBinario();
+
+    EscritorBinario(const EscritorBinario&) = delete;
+    EscritorBinario& operator=(const EscritorBinario&) = delete;
+
+    // Grava a próxima linha, com n colunas em ordem estritamente crescente
+    void gravarLinha(const int* cols, const double* valores, int n);
+
+    // Confere se todas as linhas foram gravadas, copia os valores, calcula a soma de verificação e grava o cabeçalho
+    void finalizar();
+
+    // Retorna a quantidade de elementos gravados
+    int64_t nnz() const { return m_nnz; }
+
+private:
+    std::fstream m_file;
+    std::fstream m_temporario;     // Valores, na ordem em que foram gravados
+    std::string m_nomeTemporario;
+    int m_linhas, m_colunas, m_capacidade;
+    int m_linhasGravadas;
+    int64_t m_nnz, m_descarregados;
+    std::vector<int> m_rowPtr;     // Posições de row_ptr ainda não gravadas
+    std::vector<int> m_cols;       // Colunas ainda não gravadas
+    std::vector<double> m_valores; // Valores ainda não gravados
+
+    // Grava as posições de row_ptr, as colunas e os valores acumulados
+    void descarregar();
+};
+
+#endif
@@ -0,0 +1,347 @@
+#include "bsr_matrix.h"
+#include "matrix_types.h"
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__AVX512F__) || (defined(__AVX2__) && defined(__FMA__))
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+/* Calcula a fração não nula dos blocos b x b que têm algum elemento, contando uma a cada "passo" linhas de blocos
+ * Marca, em cada linha de blocos, as colunas de blocos já vistas, para contar cada bloco uma única vez
+ * Retorna 0 se as linhas contadas não tiverem nenhum elemento
+ */
+template <typename T, typename Index>
+static double preenchimentoLinhasBloco(const CSRViewT<T, Index>& A, Index b, Index passo) {
+    Index linhasBloco = (A.linhas + b - 1) / b;
+    Index colunasBloco = (A.colunas + b - 1) / b;
+
+    vector<Index> marcador(colunasBloco + 1, 0);
+    long long elementos = 0, blocos = 0;
+    for (Index I = 1; I <= linhasBloco; I += passo) {
+        Index ultima = min<Index>(I * b, A.linhas);
+        for (Index i = (I - 1) * b + 1; i <= ultima; ++i) {
+            for (Index k = A.row_ptr[i - 1]; k < A.row_ptr[i]; ++k) {
+                Index J = (A.col_idx[k] - 1) / b + 1;
+                if (marcador[J] != I) {
+                    marcador[J] = I;
+                    ++blocos;
+                }
+            }
+            elementos += A.row_ptr[i] - A.row_ptr[i - 1];
+        }
+    }
+    return blocos == 0 ? 0.0 : static_cast<double>(elementos) / (static_cast<double>(blocos) * b * b);
+}
+
+/* Estima a fração não nula dos blocos b x b que têm algum elemento
+ * Conta os blocos e os elementos de até AMOSTRA_LINHAS_BLOCO linhas de blocos espaçadas igualmente;
+ * o custo não depende do tamanho da matriz
+ */
+template <typename T, typename Index>
+double estimarPreenchimento(const CSRViewT<T, Index>& A, Index b) {
+    Index linhasBloco = (A.linhas + b - 1) / b;
+    return preenchimentoLinhasBloco(A, b, max<Index>(1, linhasBloco / AMOSTRA_LINHAS_BLOCO));
+}
+
+/* Calcula a fração não nula dos blocos b x b que têm algum elemento, contando todas as linhas de blocos
+ * Custa uma passada pelos elementos, sem alocar os blocos
+ */
+template <typename T, typename Index>
+double calcularPreenchimento(const CSRViewT<T, Index>& A, Index b) {
+    return preenchimentoLinhasBloco(A, b, Index(1));
+}
+
+/* Escolhe o lado do bloco quadrado para o produto A * B em blocos
+ * Se nem os blocos 4 x 4 de A atingem o preenchimento mínimo, desiste sem examinar B: blocos maiores
+ * raramente ficam mais cheios; caso contrário, prefere 8 x 8, desde que as duas matrizes o atinjam
+ * Retorna 0 quando o produto elemento a elemento deve ser usado
+ */
+template <typename T, typename Index>
+Index escolherBloco(const CSRViewT<T, Index>& A, const CSRViewT<T, Index>& B) {
+    if (estimarPreenchimento(A, Index(4)) < PREENCHIMENTO_MINIMO_BSR) {
+        return 0;
+    }
+    if (estimarPreenchimento(A, Index(8)) >= PREENCHIMENTO_MINIMO_BSR &&
+        estimarPreenchimento(B, Index(8)) >= PREENCHIMENTO_MINIMO_BSR) {
+        return 8;
+    }
+    return estimarPreenchimento(B, Index(4)) >= PREENCHIMENTO_MINIMO_BSR ? 4 : 0;
+}
+
+/* Converte uma matriz CSR para a forma BSR com blocos de r x c
+ * Lança uma exceção se as dimensões do bloco não forem positivas
+ * Para cada linha de blocos, reúne as colunas de blocos que têm algum elemento, marcando as já vistas,
+ * ordena-as e copia cada elemento para a sua posição dentro do bloco
+ * O custo é proporcional aos elementos não nulos mais as posições dos blocos guardados
+ */
+template <typename T, typename Index>
+BSRMatrixT<T, Index> toBSR(const CSRViewT<T, Index>& A, Index r, Index c) {
+    if (r <= 0 || c <= 0) {
+        throw invalid_argument("Erro: As dimensoes do bloco devem ser maiores que zero.");
+    }
+
+    BSRMatrixT<T, Index> bsr;
+    bsr.linhas = A.linhas;
+    bsr.colunas = A.colunas;
+    bsr.r = r;
+    bsr.c = c;
+    size_t tamanho = static_cast<size_t>(r) * c;
+
+    vector<Index> marcador(bsr.colunasBloco() + 1, 0);
+    vector<Index> posicao(bsr.colunasBloco() + 1, 0);
+    bsr.row_ptr.reserve(bsr.linhasBloco() + 1);
+    bsr.row_ptr.push_back(0);
+    for (Index I = 1; I <= bsr.linhasBloco(); ++I) {
+        Index primeira = (I - 1) * r + 1, ultima = min<Index>(I * r, A.linhas);
+        Index inicio = bsr.blocos();
+        for (Index i = primeira; i <= ultima; ++i) {
+            for (Index k = A.row_ptr[i - 1]; k < A.row_ptr[i]; ++k) {
+                Index J = (A.col_idx[k] - 1) / c + 1;
+                if (marcador[J] != I) {
+                    marcador[J] = I;
+                    bsr.col_idx.push_back(J);
+                }
+            }
+        }
+        sort(bsr.col_idx.begin() + inicio, bsr.col_idx.end());
+        for (Index p = inicio; p < bsr.blocos(); ++p) {
+            posicao[bsr.col_idx[p]] = p;
+        }
+        bsr.values.resize(bsr.col_idx.size() * tamanho, T());
+        bsr.nnz_bloco.resize(bsr.col_idx.size(), 0);
+
+        for (Index i = primeira; i <= ultima; ++i) {
+            for (Index k = A.row_ptr[i - 1]; k < A.row_ptr[i]; ++k) {
+                Index j = A.col_idx[k] - 1;
+                Index p = posicao[j / c + 1];
+                bsr.values[p * tamanho + static_cast<size_t>(i - primeira) * c + j % c] = A.values[k];
+                ++bsr.nnz_bloco[p];
+            }
+        }
+        bsr.row_ptr.push_back(bsr.blocos());
+    }
+    return bsr;
+}
+
+/* Converte uma matriz BSR para a forma CSR
+ * Monta cada linha da matriz percorrendo a mesma linha dentro de cada bloco da sua linha de blocos,
+ * que já estão em ordem de coluna, e descarta os zeros guardados nos blocos e as posições da borda
+ */
+template <typename T, typename Index>
+CSRMatrixT<T, Index> toCSR(const BSRMatrixT<T, Index>& A) {
+    CSRMatrixT<T, Index> csr;
+    csr.linhas = A.linhas;
+    csr.colunas = A.colunas;
+    csr.row_ptr.reserve(A.linhas + 1);
+    csr.row_ptr.push_back(0);
+    csr.col_idx.reserve(A.nnz());
+    csr.values.reserve(A.nnz());
+
+    size_t tamanho = static_cast<size_t>(A.r) * A.c;
+    for (Index I = 1; I <= A.linhasBloco(); ++I) {
+        for (Index ii = 0; ii < A.r && (I - 1) * A.r + ii < A.linhas; ++ii) {
+            for (Index p = A.row_ptr[I - 1]; p < A.row_ptr[I]; ++p) {
+                const T* linha = A.values.data() + p * tamanho + static_cast<size_t>(ii) * A.c;
+                Index base = (A.col_idx[p] - 1) * A.c;
+                for (Index jj = 0; jj < A.c && base + jj < A.colunas; ++jj) {
+                    if (linha[jj] != T()) {
+                        csr.col_idx.push_back(base + jj + 1);
+                        csr.values.push_back(linha[jj]);
+                    }
+                }
+            }
+            csr.row_ptr.push_back(static_cast<Index>(csr.values.size()));
+        }
+    }
+    return csr;
+}
+
+/* Núcleo denso do produto em blocos: C += A * B, com os três blocos de B x B guardados linha a linha
+ * Cada elemento (i, k) de A multiplica a linha k de B inteira, acumulada na linha i de C;
+ * com o tamanho conhecido na compilação, o laço interno é vetorizado pelo compilador
+ */
+template <int B, typename T>
+static inline void multiplicarBlocoDenso(const T* a, const T* b, T* c) {
+    for (int i = 0; i < B; ++i) {
+        for (int k = 0; k < B; ++k) {
+            T aik = a[i * B + k];
+            for (int j = 0; j < B; ++j) {
+                c[i * B + j] += aik * b[k * B + j];
+            }
+        }
+    }
+}
+
+#if defined(__AVX2__) && defined(__FMA__)
+/* Versão vetorizada para blocos 4 x 4 de double: cada linha de B e de C ocupa um registrador de 256 bits
+ * As quatro linhas de B ficam em registradores durante todo o bloco; cada linha de C recebe quatro
+ * multiplicações-somas de uma linha de B pelo elemento de A replicado
+ */
+template <>
+inline void multiplicarBlocoDenso<4, double>(const double* a, const double* b, double* c) {
+    __m256d b0 = _mm256_loadu_pd(b), b1 = _mm256_loadu_pd(b + 4);
+    __m256d b2 = _mm256_loadu_pd(b + 8), b3 = _mm256_loadu_pd(b + 12);
+    for (int i = 0; i < 4; ++i) {
+        __m256d linha = _mm256_loadu_pd(c + 4 * i);
+        linha = _mm256_fmadd_pd(_mm256_set1_pd(a[4 * i]), b0, linha);
+        linha = _mm256_fmadd_pd(_mm256_set1_pd(a[4 * i + 1]), b1, linha);
+        linha = _mm256_fmadd_pd(_mm256_set1_pd(a[4 * i + 2]), b2, linha);
+        linha = _mm256_fmadd_pd(_mm256_set1_pd(a[4 * i + 3]), b3, linha);
+        _mm256_storeu_pd(c + 4 * i, linha);
+    }
+}
+#endif
+
+#if defined(__AVX512F__) || (defined(__AVX2__) && defined(__FMA__))
+/* Versão vetorizada para blocos 8 x 8 de double
+ * Com AVX-512, cada linha ocupa um registrador e as oito linhas de B ficam em registradores;
+ * com AVX2, cada linha ocupa dois registradores e as linhas de B são lidas da cache a cada linha de C
+ */
+template <>
+inline void multiplicarBlocoDenso<8, double>(const double* a, const double* b, double* c) {
+#if defined(__AVX512F__)
+    __m512d linhasB[8];
+    for (int k = 0; k < 8; ++k) {
+        linhasB[k] = _mm512_loadu_pd(b + 8 * k);
+    }
+    for (int i = 0; i < 8; ++i) {
+        __m512d linha = _mm512_loadu_pd(c + 8 * i);
+        for (int k = 0; k < 8; ++k) {
+            linha = _mm512_fmadd_pd(_mm512_set1_pd(a[8 * i + k]), linhasB[k], linha);
+        }
+        _mm512_storeu_pd(c + 8 * i, linha);
+    }
+#else
+    for (int i = 0; i < 8; ++i) {
+        __m256d esquerda = _mm256_loadu_pd(c + 8 * i), direita = _mm256_loadu_pd(c + 8 * i + 4);
+        for (int k = 0; k < 8; ++k) {
+            __m256d aik = _mm256_set1_pd(a[8 * i + k]);
+            esquerda = _mm256_fmadd_pd(aik, _mm256_loadu_pd(b + 8 * k), esquerda);
+            direita = _mm256_fmadd_pd(aik, _mm256_loadu_pd(b + 8 * k + 4), direita);
+        }
+        _mm256_storeu_pd(c + 8 * i, esquerda);
+        _mm256_storeu_pd(c + 8 * i + 4, direita);
+    }
+#endif
+}
+#endif
+
+/* Produto escalar para blocos de A quase vazios: C += A * B percorrendo só os elementos não nulos de A
+ * Cada um deles soma uma linha de B; as posições nulas de A não custam nada além da comparação
+ * Serve para qualquer formato de bloco: A de r x k, B de k x c e C de r x c
+ */
+template <typename T, typename Index>
+static inline void multiplicarBlocoEsparso(const T* a, const T* b, T* c, Index r, Index k, Index cc) {
+    for (Index i = 0; i < r; ++i) {
+        for (Index l = 0; l < k; ++l) {
+            T ail = a[i * k + l];
+            if (ail == T()) continue;
+            for (Index j = 0; j < cc; ++j) {
+                c[i * cc + j] += ail * b[l * cc + j];
+            }
+        }
+    }
+}
+
+/* Multiplica duas matrizes BSR pelo algoritmo de Gustavson aplicado aos blocos
+ * A linha de blocos I de C combina as linhas de blocos de B indicadas pelos blocos da linha I de A;
+ * cada par de blocos (I, K) de A e (K, J) de B é somado ao bloco J da linha, acumulado em um vetor denso
+ * de blocos, com um marcador por coluna de blocos. No fim da linha, os blocos são ordenados pela coluna
+ * e copiados para C, sem os que ficaram nulos
+ * "nucleo" calcula C += A * B para um par de blocos e recebe a quantidade de não nulos do bloco de A
+ */
+template <typename T, typename Index, typename Nucleo>
+static BSRMatrixT<T, Index> multiplicarBlocos(const BSRMatrixT<T, Index>& A, const BSRMatrixT<T, Index>& B,
+                                              Nucleo nucleo) {
+    BSRMatrixT<T, Index> C;
+    C.linhas = A.linhas;
+    C.colunas = B.colunas;
+    C.r = A.r;
+    C.c = B.c;
+    size_t tamanhoA = static_cast<size_t>(A.r) * A.c;
+    size_t tamanhoB = static_cast<size_t>(B.r) * B.c;
+    size_t tamanhoC = static_cast<size_t>(C.r) * C.c;
+
+    vector<Index> marcador(C.colunasBloco() + 1, 0);
+    vector<Index> posicao(C.colunasBloco() + 1, 0);
+    vector<Index> presentes;
+    vector<T> acumulados;
+    C.row_ptr.reserve(C.linhasBloco() + 1);
+    C.row_ptr.push_back(0);
+
+    for (Index I = 1; I <= A.linhasBloco(); ++I) {
+        presentes.clear();
+        for (Index p = A.row_ptr[I - 1]; p < A.row_ptr[I]; ++p) {
+            Index K = A.col_idx[p];
+            const T* blocoA = A.values.data() + p * tamanhoA;
+            for (Index q = B.row_ptr[K - 1]; q < B.row_ptr[K]; ++q) {
+                Index J = B.col_idx[q];
+                if (marcador[J] != I) {
+                    marcador[J] = I;
+                    posicao[J] = static_cast<Index>(presentes.size());
+                    presentes.push_back(J);
+                    if (acumulados.size() < presentes.size() * tamanhoC) {
+                        acumulados.resize(presentes.size() * tamanhoC);
+                    }
+                    fill_n(acumulados.begin() + posicao[J] * tamanhoC, tamanhoC, T());
+                }
+                nucleo(blocoA, A.nnz_bloco[p], B.values.data() + q * tamanhoB, acumulados.data() + posicao[J] * tamanhoC);
+            }
+        }
+
+        sort(presentes.begin(), presentes.end());
+        for (Index J : presentes) {
+            const T* bloco = acumulados.data() + posicao[J] * tamanhoC;
+            Index naoNulos = static_cast<Index>(count_if(bloco, bloco + tamanhoC, [](const T& v) { return v != T(); }));
+            if (naoNulos == 0) continue;
+            C.col_idx.push_back(J);
+            C.nnz_bloco.push_back(naoNulos);
+            C.values.insert(C.values.end(), bloco, bloco + tamanhoC);
+        }
+        C.row_ptr.push_back(C.blocos());
+    }
+    return C;
+}
+
+/* Multiplica duas matrizes BSR
+ * Verifica se as dimensões das matrizes e dos blocos são compatíveis, lançando uma exceção se não forem
+ * Com blocos quadrados de 4 x 4 ou 8 x 8, usa o núcleo denso, vetorizado, para os blocos de A com mais de
+ * um quarto das posições preenchidas, e o produto escalar que pula os zeros para os demais;
+ * outros formatos de bloco usam sempre o produto escalar
+ */
+template <typename T, typename Index>
+BSRMatrixT<T, Index> multiplyBSR(const BSRMatrixT<T, Index>& A, const BSRMatrixT<T, Index>& B) {
+    if (A.colunas != B.linhas || A.c != B.r) {
+        throw runtime_error("As matrizes tem dimensoes incompativeis para multiplicacao.");
+    }
+
+    bool quadrado = A.r == A.c && B.r == A.r && B.c == A.r;
+    if (quadrado && A.r == 4) {
+        return multiplicarBlocos(A, B, [](const T* a, Index naoNulos, const T* b, T* c) {
+            if (naoNulos * 4 > 16) multiplicarBlocoDenso<4>(a, b, c);
+            else multiplicarBlocoEsparso<T, Index>(a, b, c, 4, 4, 4);
+        });
+    }
+    if (quadrado && A.r == 8) {
+        return multiplicarBlocos(A, B, [](const T* a, Index naoNulos, const T* b, T* c) {
+            if (naoNulos * 4 > 64) multiplicarBlocoDenso<8>(a, b, c);
+            else multiplicarBlocoEsparso<T, Index>(a, b, c, 8, 8, 8);
+        });
+    }
+    Index r = A.r, k = A.c, cc = B.c;
+    return multiplicarBlocos(A, B, [r, k, cc](const T* a, Index, const T* b, T* c) {
+        multiplicarBlocoEsparso(a, b, c, r, k, cc);
+    });
+}
+
+#define INSTANCIAR(T, Index)                                                                               \
+    template double estimarPreenchimento(const CSRViewT<T, Index>&, Index);                                \
+    template double calcularPreenchimento(const CSRViewT<T, Index>&, Index);                               \
+    template Index escolherBloco(const CSRViewT<T, Index>&, const CSRViewT<T, Index>&);                     \
+    template BSRMatrixT<T, Index> toBSR(const CSRViewT<T, Index>&, Index, Index);                           \
+    template CSRMatrixT<T, Index> toCSR(const BSRMatrixT<T, Index>&);                                       \
+    template BSRMatrixT<T, Index> multiplyBSR(const BSRMatrixT<T, Index>&, const BSRMatrixT<T, Index>&);
+PARA_CADA_TIPO_MATRIZ(INSTANCIAR)
@@ -0,0 +1,84 @@
+#ifndef BSR_MATRIX_H
+#define BSR_MATRIX_H
+
+#include "csr_matrix.h"
+#include <cstddef>
+#include <vector>
+
+// Definição da estrutura BSRMatrixT, representação comprimida por linhas de blocos (block sparse row)
+// A matriz é dividida em blocos densos de r x c posições e só os blocos com algum elemento não nulo são guardados.
+// Os blocos da linha de blocos I ocupam as posições [row_ptr[I - 1], row_ptr[I]) de col_idx, em ordem crescente
+// de coluna de blocos; os valores do bloco k ficam em values[k * r * c, (k + 1) * r * c), linha a linha.
+// Linhas e colunas de blocos começam em 1, como em CSRMatrixT; nos blocos da borda, as posições que passam
+// das dimensões da matriz ficam em zero.
+template <typename T, typename Index>
+struct BSRMatrixT {
+    Index linhas = 0, colunas = 0; // Dimensões da matriz
+    Index r = 0, c = 0;            // Dimensões de cada bloco
+    std::vector<Index> row_ptr;    // Início de cada linha de blocos em col_idx (linhasBloco() + 1 posições)
+    std::vector<Index> col_idx;    // Coluna de blocos de cada bloco guardado
+    std::vector<Index> nnz_bloco;  // Elementos não nulos de cada bloco
+    std::vector<T> values;         // Valores dos blocos, r * c por bloco
+
+    // Retorna a quantidade de linhas e de colunas de blocos
+    Index linhasBloco() const { return (linhas + r - 1) / r; }
+    Index colunasBloco() const { return (colunas + c - 1) / c; }
+
+    // Retorna a quantidade de blocos guardados
+    Index blocos() const { return static_cast<Index>(col_idx.size()); }
+
+    // Retorna a quantidade de elementos não nulos
+    long long nnz() const {
+        long long total = 0;
+        for (Index n : nnz_bloco) total += n;
+        return total;
+    }
+
+    // Retorna a fração das posições dos blocos guardados que não são nulas
+    double preenchimento() const {
+        return col_idx.empty() ? 0.0 : static_cast<double>(nnz()) / (static_cast<double>(col_idx.size()) * r * c);
+    }
+
+    // Retorna a quantidade de bytes ocupados pelos vetores
+    std::size_t bytes() const {
+        return (row_ptr.size() + col_idx.size() + nnz_bloco.size()) * sizeof(Index) + values.size() * sizeof(T);
+    }
+};
+
+using BSRMatrix = BSRMatrixT<double, int>;
+
+// Preenchimento mínimo dos blocos para que o produto em blocos compense: abaixo dele, o núcleo denso
+// calcularia mais produtos com zeros do que o produto elemento a elemento calcula ao todo
+constexpr double PREENCHIMENTO_MINIMO_BSR = 0.5;
+
+// Quantidade de linhas de blocos, espaçadas ao longo da matriz, examinadas por escolherBloco
+constexpr int AMOSTRA_LINHAS_BLOCO = 512;
+
+// Estima a fração não nula dos blocos b x b não vazios da matriz, contando uma amostra de linhas de blocos
+template <typename T, typename Index>
+double estimarPreenchimento(const CSRViewT<T, Index>& A, Index b);
+
+// Calcula a fração não nula dos blocos b x b não vazios da matriz inteira, em uma passada pelos elementos
+template <typename T, typename Index>
+double calcularPreenchimento(const CSRViewT<T, Index>& A, Index b);
+
+// Escolhe o lado do bloco quadrado (8 ou 4) para multiplicar A * B em blocos, ou retorna 0 se nenhum
+// deixa os blocos das duas matrizes com preenchimento estimado de pelo menos PREENCHIMENTO_MINIMO_BSR
+template <typename T, typename Index>
+Index escolherBloco(const CSRViewT<T, Index>& A, const CSRViewT<T, Index>& B);
+
+// Converte uma matriz CSR para a forma BSR com blocos de r x c
+template <typename T, typename Index>
+BSRMatrixT<T, Index> toBSR(const CSRViewT<T, Index>& A, Index r, Index c);
+
+// Converte uma matriz BSR para a forma CSR, descartando os zeros guardados nos blocos
+template <typename T, typename Index>
+CSRMatrixT<T, Index> toCSR(const BSRMatrixT<T, Index>& A);
+
+// Multiplica duas matrizes BSR (colunas de A == linhas de B e A.c == B.r); o resultado tem blocos de A.r x B.c
+// Blocos densos são multiplicados por um núcleo vetorizado (AVX2+FMA ou AVX-512 para double com blocos
+// de 4 x 4 ou 8 x 8); blocos de A quase vazios usam o produto escalar que só percorre os seus não nulos
+template <typename T, typename Index>
+BSRMatrixT<T, Index> multiplyBSR(const BSRMatrixT<T, Index>& A, const BSRMatrixT<T, Index>& B);
+
+#endif
@@ -0,0 +1,345 @@
+#include "concurrent_matrix.h"
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+/* Constrói uma matriz vazia com m linhas e n colunas
+ * Verifica se as dimensões são válidas, lançando uma exceção se não forem
+ * Todas as linhas começam sem nenhuma versão, o que equivale a vazias em qualquer versão da matriz
+ */
+ConcurrentSparseMatrix::ConcurrentSparseMatrix(int m, int n)
+    : linhas(m), colunas(n), m_versao(0), m_liberadas(0) {
+    if (m <= 0 || n <= 0) {
+        throw invalid_argument("Erro: Dimensoes invalidas! Linhas e colunas devem ser maiores que zero.");
+    }
+
+    m_linhas.reset(new atomic<VersaoLinha*>[m]);
+    for (int i = 0; i < m; ++i) {
+        m_linhas[i].store(nullptr, memory_order_relaxed);
+    }
+    m_leitores.reset(new SlotLeitor[MAX_LEITORES]);
+}
+
+/* Constrói a matriz com os elementos de outra
+ * Copia cada linha não vazia da forma CSR para a sua versão 0; nenhuma thread lê a matriz ainda
+ */
+ConcurrentSparseMatrix::ConcurrentSparseMatrix(const SparseMatrix& A)
+    : ConcurrentSparseMatrix(A.getLinhas(), A.getColunas()) {
+    CSRMatrix csr = A.toCSR();
+    for (int i = 1; i <= linhas; ++i) {
+        int inicio = csr.row_ptr[i - 1], n = csr.row_ptr[i] - inicio;
+        if (n == 0) continue;
+
+        VersaoLinha* v = criarVersao(n, 0, nullptr);
+        copy(csr.values.begin() + inicio, csr.values.begin() + inicio + n, v->valores());
+        copy(csr.col_idx.begin() + inicio, csr.col_idx.begin() + inicio + n, v->colunas());
+        m_linhas[i - 1].store(v, memory_order_relaxed);
+    }
+}
+
+/* Destrói a matriz liberando todas as versões de todas as linhas
+ * As aposentadas ainda ligadas às sucessoras são alcançadas pela lista de versões de cada linha
+ */
+ConcurrentSparseMatrix::~ConcurrentSparseMatrix() {
+    for (int i = 0; i < linhas; ++i) {
+        VersaoLinha* v = m_linhas[i].load(memory_order_relaxed);
+        while (v) {
+            VersaoLinha* anterior = v->anterior.load(memory_order_relaxed);
+            liberarVersao(v);
+            v = anterior;
+        }
+    }
+}
+
+/* Aloca em um único bloco o cabeçalho, os n valores e as n colunas de uma versão de linha
+ * Os valores vêm logo após o cabeçalho, cujo tamanho é múltiplo de 8, e as colunas depois deles
+ */
+ConcurrentSparseMatrix::VersaoLinha* ConcurrentSparseMatrix::criarVersao(int n, long long versao, VersaoLinha* anterior) {
+    void* memoria = ::operator new(sizeof(VersaoLinha) + static_cast<size_t>(n) * (sizeof(double) + sizeof(int)));
+    VersaoLinha* v = static_cast<VersaoLinha*>(memoria);
+    v->versao = versao;
+    new (&v->anterior) atomic<VersaoLinha*>(anterior);
+    v->n = n;
+    return v;
+}
+
+// Libera o bloco de uma versão de linha
+void ConcurrentSparseMatrix::liberarVersao(VersaoLinha* v) {
+    ::operator delete(v);
+}
+
+/* Localiza a versão da linha i vista na versão "versao" da matriz
+ * Parte da versão mais nova e recua até a primeira publicada até "versao"
+ * As versões percorridas não são liberadas enquanto o snapshot que as procura estiver aberto
+ */
+const ConcurrentSparseMatrix::VersaoLinha* ConcurrentSparseMatrix::linhaNaVersao(int i, long long versao) const {
+    const VersaoLinha* v = m_linhas[i - 1].load(memory_order_acquire);
+    while (v && v->versao > versao) {
+        v = v->anterior.load(memory_order_acquire);
+    }
+    return v;
+}
+
+/* Insere, atualiza ou remove (valor 0) o elemento (i, j)
+ * Verifica se os índices são válidos, lançando uma exceção se não forem
+ * Copia a versão atual da linha com a alteração aplicada, mantendo as colunas em ordem crescente,
+ * e a publica como uma nova versão da matriz; não publica nada se a linha não mudar
+ * O custo é proporcional ao tamanho da linha, independentemente da quantidade de leitores
+ */
+void ConcurrentSparseMatrix::inserir(int i, int j, double valor) {
+    if (i < 1 || i > linhas || j < 1 || j > colunas) {
+        throw out_of_range("Erro: Indices fora dos limites da matriz.");
+    }
+
+    lock_guard<mutex> trava(m_escrita);
+    VersaoLinha* atual = m_linhas[i - 1].load(memory_order_relaxed);
+    int n = atual ? atual->n : 0;
+    const int* cols = atual ? atual->colunas() : nullptr;
+    const double* valores = atual ? atual->valores() : nullptr;
+    int pos = static_cast<int>(lower_bound(cols, cols + n, j) - cols);
+    bool existe = pos < n && cols[pos] == j;
+
+    if (valor == 0 ? !existe : existe && valores[pos] == valor) return;
+
+    int novoN = n + (valor == 0 ? -1 : (existe ? 0 : 1));
+    VersaoLinha* nova = criarVersao(novoN, 0, atual);
+    double* novosValores = nova->valores();
+    int* novasCols = nova->colunas();
+    copy(cols, cols + pos, novasCols);
+    copy(valores, valores + pos, novosValores);
+    int k = pos;
+    if (valor != 0) {
+        novasCols[k] = j;
+        novosValores[k] = valor;
+        ++k;
+    }
+    int resto = existe ? pos + 1 : pos;
+    copy(cols + resto, cols + n, novasCols + k);
+    copy(valores + resto, valores + n, novosValores + k);
+
+    publicar(i, nova);
+}
+
+/* Substitui a linha i por uma nova, com as colunas e os valores informados, em uma única versão
+ * Verifica os índices e a ordem das colunas, lançando exceções se forem inválidos
+ * Ignora valores nulos, preservando a ausência de zeros na estrutura
+ */
+void ConcurrentSparseMatrix::substituirLinha(int i, const vector<int>& cols, const vector<double>& valores) {
+    if (i < 1 || i > linhas) {
+        throw out_of_range("Erro: Indices fora dos limites da matriz.");
+    }
+    if (cols.size() != valores.size()) {
+        throw invalid_argument("Erro: Quantidade de colunas e de valores diferentes.");
+    }
+    int coluna_anterior = 0, n = 0;
+    for (size_t k = 0; k < cols.size(); ++k) {
+        if (cols[k] <= coluna_anterior || cols[k] > colunas) {
+            throw out_of_range("Erro: Colunas fora dos limites ou fora de ordem.");
+        }
+        coluna_anterior = cols[k];
+        if (valores[k] != 0) ++n;
+    }
+
+    lock_guard<mutex> trava(m_escrita);
+    VersaoLinha* nova = criarVersao(n, 0, m_linhas[i - 1].load(memory_order_relaxed));
+    int k = 0;
+    for (size_t c = 0; c < cols.size(); ++c) {
+        if (valores[c] == 0) continue;
+        nova->colunas()[k] = cols[c];
+        nova->valores()[k] = valores[c];
+        ++k;
+    }
+    publicar(i, nova);
+}
+
+/* Publica a nova versão da linha i como a próxima versão da matriz
+ * A linha é trocada antes de a versão da matriz avançar: um snapshot que enxerga a nova versão
+ * da matriz enxerga também a nova linha, e um snapshot anterior a ela recua para a versão substituída
+ * A versão substituída é aposentada com a versão da matriz que a substituiu; quando há muitas
+ * aposentadas, tenta liberá-las
+ */
+void ConcurrentSparseMatrix::publicar(int i, VersaoLinha* nova) {
+    long long proxima = m_versao.load(memory_order_relaxed) + 1;
+    nova->versao = proxima;
+    m_linhas[i - 1].store(nova, memory_order_release);
+    m_versao.store(proxima, memory_order_seq_cst);
+
+    if (nova->anterior.load(memory_order_relaxed)) {
+        m_aposentadas.push_back({proxima, nova});
+    }
+    if (m_aposentadas.size() >= LIMITE_APOSENTADAS) {
+        recuperar();
+    }
+}
+
+/* Libera as versões aposentadas que nenhum snapshot pode mais enxergar
+ * Obtém a menor versão entre os snapshots abertos (ou a versão atual, se não houver nenhum)
+ * Uma versão substituída na versão v da matriz só é vista por snapshots de versão menor que v;
+ * como nenhum snapshot novo recebe versão menor que a atual, ela pode ser liberada se v <= menor
+ * As aposentadas estão em ordem de substituição, então as liberáveis formam um prefixo da lista;
+ * a versão liberada é desligada da sucessora, que continua viva por ter sido substituída depois
+ */
+void ConcurrentSparseMatrix::recuperar() {
+    long long menor = m_versao.load(memory_order_seq_cst);
+    for (int s = 0; s < MAX_LEITORES; ++s) {
+        long long v = m_leitores[s].versao.load(memory_order_seq_cst);
+        if (v != LIVRE) menor = min(menor, v);
+    }
+
+    size_t k = 0;
+    while (k < m_aposentadas.size() && m_aposentadas[k].substituidaEm <= menor) {
+        VersaoLinha* sucessora = m_aposentadas[k].sucessora;
+        VersaoLinha* velha = sucessora->anterior.load(memory_order_relaxed);
+        sucessora->anterior.store(nullptr, memory_order_relaxed);
+        liberarVersao(velha);
+        ++k;
+    }
+    m_aposentadas.erase(m_aposentadas.begin(), m_aposentadas.begin() + k);
+    m_liberadas += static_cast<long long>(k);
+}
+
+/* Ocupa uma posição livre da tabela de leitores e fixa nela a versão atual da matriz
+ * Cada thread começa a procura por uma posição própria, o que evita disputas entre leitores
+ * Depois de gravar a versão na posição, relê a versão da matriz: se ela avançou, a escrita pode
+ * ter procurado os leitores antes da gravação, então grava a nova versão e confere de novo
+ * Quando a escrita procura os leitores depois da gravação, ela não libera nada que a versão gravada enxerga
+ * Se todas as posições estiverem ocupadas, cede a vez e tenta de novo
+ */
+int ConcurrentSparseMatrix::registrarLeitor(long long& versao) const {
+    static atomic<unsigned> proximaThread{0};
+    thread_local unsigned inicio = proximaThread.fetch_add(1, memory_order_relaxed);
+
+    versao = m_versao.load(memory_order_seq_cst);
+    for (;;) {
+        for (int t = 0; t < MAX_LEITORES; ++t) {
+            int s = static_cast<int>((inicio + t) % MAX_LEITORES);
+            long long livre = LIVRE;
+            if (m_leitores[s].versao.compare_exchange_strong(livre, versao, memory_order_seq_cst)) {
+                for (;;) {
+                    long long atual = m_versao.load(memory_order_seq_cst);
+                    if (atual == versao) return s;
+                    versao = atual;
+                    m_leitores[s].versao.store(versao, memory_order_seq_cst);
+                }
+            }
+        }
+        this_thread::yield();
+    }
+}
+
+/* Abre um snapshot da versão atual da matriz, sem travas
+ */
+ConcurrentSparseMatrix::Snapshot ConcurrentSparseMatrix::snapshot() const {
+    long long versao;
+    int slot = registrarLeitor(versao);
+    return Snapshot(this, slot, versao);
+}
+
+/* Retorna a quantidade de versões aposentadas que ainda não foram liberadas
+ */
+size_t ConcurrentSparseMatrix::versoesPendentes() {
+    lock_guard<mutex> trava(m_escrita);
+    return m_aposentadas.size();
+}
+
+/* Retorna a quantidade de versões de linha liberadas desde a construção
+ */
+long long ConcurrentSparseMatrix::versoesLiberadas() {
+    lock_guard<mutex> trava(m_escrita);
+    return m_liberadas;
+}
+
+/* Fecha o snapshot, devolvendo a sua posição na tabela de leitores
+ * A partir daí, as versões que só ele enxergava podem ser liberadas pela escrita
+ */
+ConcurrentSparseMatrix::Snapshot::~Snapshot() {
+    if (matriz) {
+        matriz->m_leitores[slot].versao.store(LIVRE, memory_order_release);
+    }
+}
+
+/* Retorna o valor armazenado em (i, j) na versão do snapshot
+ * Lança uma exceção se os índices forem inválidos
+ * Faz uma busca binária entre as colunas da versão da linha, que estão ordenadas
+ */
+double ConcurrentSparseMatrix::Snapshot::get(int i, int j) const {
+    if (i < 1 || i > matriz->linhas || j < 1 || j > matriz->colunas) {
+        throw out_of_range("Erro: Indices fora dos limites da matriz.");
+    }
+    const VersaoLinha* v = matriz->linhaNaVersao(i, m_versao);
+    if (!v) return 0.0;
+
+    const int* cols = v->colunas();
+    const int* pos = lower_bound(cols, cols + v->n, j);
+    return (pos != cols + v->n && *pos == j) ? v->valores()[pos - cols] : 0.0;
+}
+
+/* Retorna a quantidade de elementos não nulos da linha i na versão do snapshot
+ * Lança uma exceção se o índice for inválido
+ */
+int ConcurrentSparseMatrix::Snapshot::countNonZeroRow(int i) const {
+    if (i < 1 || i > matriz->linhas) {
+        throw out_of_range("Erro: Indices fora dos limites da matriz.");
+    }
+    const VersaoLinha* v = matriz->linhaNaVersao(i, m_versao);
+    return v ? v->n : 0;
+}
+
+/* Soma os tamanhos das versões das linhas vistas pelo snapshot
+ * O custo é proporcional ao número de linhas
+ */
+long long ConcurrentSparseMatrix::Snapshot::countNonZero() const {
+    long long total = 0;
+    for (int i = 1; i <= matriz->linhas; ++i) {
+        const VersaoLinha* v = matriz->linhaNaVersao(i, m_versao);
+        if (v) total += v->n;
+    }
+    return total;
+}
+
+/* Multiplica a matriz, na versão do snapshot, pelo vetor x
+ * Verifica se o tamanho de x é igual ao número de colunas, lançando uma exceção se não for
+ * Todas as linhas são lidas na mesma versão, mesmo que a escrita publique outras durante o produto
+ */
+vector<double> ConcurrentSparseMatrix::Snapshot::multiplyVector(const vector<double>& x) const {
+    if (static_cast<int>(x.size()) != matriz->colunas) {
+        throw runtime_error("O vetor tem tamanho incompativel com a matriz.");
+    }
+
+    vector<double> y(matriz->linhas, 0.0);
+    for (int i = 1; i <= matriz->linhas; ++i) {
+        const VersaoLinha* v = matriz->linhaNaVersao(i, m_versao);
+        if (!v) continue;
+        const int* cols = v->colunas();
+        const double* valores = v->valores();
+        double total = 0.0;
+        for (int k = 0; k < v->n; ++k) {
+            total += valores[k] * x[cols[k] - 1];
+        }
+        y[i - 1] = total;
+    }
+    return y;
+}
+
+/* Copia a matriz, na versão do snapshot, para a forma CSR
+ * O resultado pode ser usado para construir uma SparseMatrix comum
+ */
+CSRMatrix ConcurrentSparseMatrix::Snapshot::toCSR() const {
+    CSRMatrix csr;
+    csr.linhas = matriz->linhas;
+    csr.colunas = matriz->colunas;
+    csr.row_ptr.reserve(csr.linhas + 1);
+    csr.row_ptr.push_back(0);
+    for (int i = 1; i <= matriz->linhas; ++i) {
+        const VersaoLinha* v = matriz->linhaNaVersao(i, m_versao);
+        if (v) {
+            csr.col_idx.insert(csr.col_idx.end(), v->colunas(), v->colunas() + v->n);
+            csr.values.insert(csr.values.end(), v->valores(), v->valores() + v->n);
+        }
+        csr.row_ptr.push_back(csr.nnz());
+    }
+    return csr;
+}
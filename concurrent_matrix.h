@@ -0,0 +1,157 @@
+#ifndef CONCURRENT_MATRIX_H
+#define CONCURRENT_MATRIX_H
+
+#include "sparse_matrix.h"
+#include "csr_matrix.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Definição da classe ConcurrentSparseMatrix, matriz esparsa para uma thread que escreve e muitas que leem
+// Cada linha é uma lista de versões imutáveis, da mais nova para a mais antiga. Uma escrita copia a linha,
+// aplica a alteração e publica a cópia atomicamente como uma nova versão da matriz; as leituras nunca travam.
+// Um leitor abre um Snapshot, que fixa a versão da matriz no momento da abertura: todas as leituras feitas
+// por ele enxergam a matriz exatamente nessa versão, mesmo que a escrita continue em paralelo.
+// As versões substituídas são liberadas pela escrita quando nenhum snapshot aberto pode mais enxergá-las
+// (recuperação por épocas, em que a época de um leitor é a versão do seu snapshot).
+class ConcurrentSparseMatrix {
+private:
+    // Valor da posição de um leitor na tabela de épocas quando nenhum snapshot a ocupa
+    static constexpr long long LIVRE = -1;
+
+    // Versão imutável de uma linha: as colunas e os valores ficam no mesmo bloco, logo após o cabeçalho
+    struct VersaoLinha {
+        long long versao;                      // Versão da matriz em que esta versão da linha foi publicada
+        std::atomic<VersaoLinha*> anterior;    // Versão anterior da linha (nullptr se não houver ou se já foi liberada)
+        int n;                                 // Quantidade de elementos da linha
+
+        double* valores() { return reinterpret_cast<double*>(this + 1); }
+        int* colunas() { return reinterpret_cast<int*>(valores() + n); }
+        const double* valores() const { return reinterpret_cast<const double*>(this + 1); }
+        const int* colunas() const { return reinterpret_cast<const int*>(valores() + n); }
+    };
+
+    // Posição de um leitor na tabela de épocas, alinhada para que leitores diferentes não disputem a mesma linha de cache
+    struct alignas(64) SlotLeitor {
+        std::atomic<long long> versao{LIVRE};
+    };
+
+    // Versão da linha aposentada e a versão da matriz que a substituiu
+    struct Aposentada {
+        long long substituidaEm;
+        VersaoLinha* sucessora;     // Versão que a substituiu, cujo "anterior" aponta para ela
+    };
+
+    int linhas, colunas; // Dimensões da matriz
+    std::unique_ptr<std::atomic<VersaoLinha*>[]> m_linhas; // Versão mais nova de cada linha (nullptr: vazia desde o início)
+    std::atomic<long long> m_versao; // Última versão publicada da matriz
+    std::unique_ptr<SlotLeitor[]> m_leitores; // Versão de cada snapshot aberto, ou LIVRE
+    std::mutex m_escrita; // Serializa as escritas, que podem vir de mais de uma thread
+    std::vector<Aposentada> m_aposentadas; // Versões substituídas ainda não liberadas, em ordem de substituição
+    long long m_liberadas; // Versões de linha já liberadas
+
+    // Aloca uma versão de linha com espaço para n elementos
+    static VersaoLinha* criarVersao(int n, long long versao, VersaoLinha* anterior);
+
+    // Libera uma versão de linha
+    static void liberarVersao(VersaoLinha* v);
+
+    // Retorna a versão da linha i visível na versão "versao" da matriz, ou nullptr se a linha estava vazia
+    const VersaoLinha* linhaNaVersao(int i, long long versao) const;
+
+    // Publica uma nova versão da linha i, que substitui a atual, e aposenta a atual; exige m_escrita travado
+    void publicar(int i, VersaoLinha* nova);
+
+    // Libera as versões aposentadas que nenhum snapshot aberto pode mais enxergar; exige m_escrita travado
+    void recuperar();
+
+    // Ocupa uma posição na tabela de leitores e fixa nela a versão atual da matriz
+    int registrarLeitor(long long& versao) const;
+
+public:
+    // Quantidade máxima de snapshots abertos ao mesmo tempo; quem abre mais um espera algum ser fechado
+    static constexpr int MAX_LEITORES = 64;
+
+    // Quantidade de versões aposentadas a partir da qual cada escrita tenta liberá-las
+    static constexpr std::size_t LIMITE_APOSENTADAS = 256;
+
+    // Visão somente leitura da matriz em uma versão fixa, aberta por ConcurrentSparseMatrix::snapshot()
+    // Enquanto estiver aberta, as versões de linha que ela enxerga não são liberadas; deve ser fechada
+    // (destruída) antes da matriz e usada por uma única thread
+    class Snapshot {
+    private:
+        const ConcurrentSparseMatrix* matriz;
+        int slot;
+        long long m_versao;
+
+        friend class ConcurrentSparseMatrix;
+        Snapshot(const ConcurrentSparseMatrix* m, int s, long long v) : matriz(m), slot(s), m_versao(v) {}
+
+    public:
+        Snapshot(Snapshot&& outro) noexcept : matriz(outro.matriz), slot(outro.slot), m_versao(outro.m_versao) {
+            outro.matriz = nullptr;
+        }
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+        Snapshot& operator=(Snapshot&&) = delete;
+
+        // Fecha o snapshot, liberando a sua posição na tabela de leitores
+        ~Snapshot();
+
+        // Retorna a versão da matriz vista pelo snapshot
+        long long versao() const { return m_versao; }
+
+        // Retorna o valor armazenado em (i, j), ou 0 se não existir
+        double get(int i, int j) const;
+
+        // Retorna a quantidade de elementos não nulos da linha i
+        int countNonZeroRow(int i) const;
+
+        // Retorna a quantidade de elementos não nulos da matriz, somando as linhas
+        long long countNonZero() const;
+
+        // Multiplica a matriz pelo vetor x (y = A * x)
+        std::vector<double> multiplyVector(const std::vector<double>& x) const;
+
+        // Gera uma cópia da matriz na forma CSR
+        CSRMatrix toCSR() const;
+    };
+
+    // Construtor da classe, cria uma matriz vazia com m linhas e n colunas
+    ConcurrentSparseMatrix(int m, int n);
+
+    // Constrói a matriz com os elementos de outra, como versão 0
+    explicit ConcurrentSparseMatrix(const SparseMatrix& A);
+
+    // Destrutor da classe; nenhum snapshot pode estar aberto
+    ~ConcurrentSparseMatrix();
+
+    ConcurrentSparseMatrix(const ConcurrentSparseMatrix&) = delete;
+    ConcurrentSparseMatrix& operator=(const ConcurrentSparseMatrix&) = delete;
+
+    // Insere ou atualiza um valor, publicando uma nova versão da linha i; o valor 0 remove o elemento
+    // Pode ser chamada enquanto outras threads leem; escritas simultâneas são serializadas
+    void inserir(int i, int j, double valor);
+
+    // Substitui a linha i inteira, em uma única versão, por colunas em ordem estritamente crescente
+    void substituirLinha(int i, const std::vector<int>& cols, const std::vector<double>& valores);
+
+    // Abre um snapshot da versão atual da matriz, sem travas
+    Snapshot snapshot() const;
+
+    // Retorna a última versão publicada
+    long long versao() const { return m_versao.load(std::memory_order_acquire); }
+
+    // Retorna quantas versões de linha substituídas aguardam liberação e quantas já foram liberadas
+    std::size_t versoesPendentes();
+    long long versoesLiberadas();
+
+    // Retorna o número de linhas da matriz
+    int getLinhas() const { return linhas; }
+
+    // Retorna o número de colunas da matriz
+    int getColunas() const { return colunas; }
+};
+
+#endif
@@ -0,0 +1,121 @@
+#include "csr_matrix.h"
+#include "matrix_types.h"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+/* Retorna o valor armazenado na posição (i, j)
+ * Faz uma busca binária entre as colunas da linha i, que estão ordenadas
+ * Retorna 0 caso a posição esteja vazia
+ */
+template <typename T, typename Index>
+T CSRViewT<T, Index>::get(Index i, Index j) const {
+    const Index* inicio = col_idx + row_ptr[i - 1];
+    const Index* fim = col_idx + row_ptr[i];
+    const Index* pos = lower_bound(inicio, fim, j);
+    return (pos != fim && *pos == j) ? values[pos - col_idx] : T();
+}
+
+/* Calcula a transposta de uma matriz CSR por contagem
+ * Conta quantos elementos cada coluna possui e acumula as contagens em row_ptr da transposta
+ * Distribui os elementos percorrendo A linha a linha, o que mantém cada linha da transposta ordenada
+ * O custo total é proporcional a linhas + colunas + elementos não nulos
+ */
+template <typename T, typename Index>
+CSRMatrixT<T, Index> transpor(const CSRViewT<T, Index>& A) {
+    CSRMatrixT<T, Index> R;
+    R.linhas = A.colunas;
+    R.colunas = A.linhas;
+    R.row_ptr.assign(R.linhas + 1, 0);
+    R.col_idx.resize(A.nnz());
+    R.values.resize(A.nnz());
+
+    for (Index k = 0; k < A.nnz(); ++k) {
+        R.row_ptr[A.col_idx[k]]++;
+    }
+    for (Index j = 1; j <= R.linhas; ++j) {
+        R.row_ptr[j] += R.row_ptr[j - 1];
+    }
+
+    vector<Index> proximo(R.row_ptr.begin(), R.row_ptr.end() - 1);
+    for (Index i = 1; i <= A.linhas; ++i) {
+        for (Index k = A.row_ptr[i - 1]; k < A.row_ptr[i]; ++k) {
+            Index destino = proximo[A.col_idx[k] - 1]++;
+            R.col_idx[destino] = i;
+            R.values[destino] = A.values[k];
+        }
+    }
+
+    return R;
+}
+
+/* Monta a matriz completa a partir do triângulo inferior
+ * Transpõe o triângulo por contagem, obtendo o triângulo superior com as linhas já ordenadas
+ * Cada linha i da matriz completa é a linha i do triângulo (colunas até i) seguida da linha i
+ * do superior sem a diagonal (colunas depois de i), o que a mantém ordenada sem outra ordenação
+ * Na antissimétrica, os elementos espelhados trocam de sinal
+ */
+CSRMatrix expandirSimetria(const CSRView& triangulo, Simetria simetria) {
+    CSRMatrix A;
+    A.linhas = triangulo.linhas;
+    A.colunas = triangulo.colunas;
+    if (simetria == Simetria::Geral) {
+        A.row_ptr.assign(triangulo.row_ptr, triangulo.row_ptr + triangulo.linhas + 1);
+        A.col_idx.assign(triangulo.col_idx, triangulo.col_idx + triangulo.nnz());
+        A.values.assign(triangulo.values, triangulo.values + triangulo.nnz());
+        return A;
+    }
+
+    for (int i = 1; i <= triangulo.linhas; ++i) {
+        if (triangulo.row_ptr[i] > triangulo.row_ptr[i - 1] && triangulo.col_idx[triangulo.row_ptr[i] - 1] > i) {
+            throw invalid_argument("Erro: A matriz simetrica deve guardar apenas o triangulo inferior.");
+        }
+    }
+
+    CSRMatrix superior = transpor(triangulo);
+    double sinal = simetria == Simetria::AntiSimetrica ? -1.0 : 1.0;
+
+    A.row_ptr.assign(A.linhas + 1, 0);
+    A.col_idx.reserve(2 * static_cast<size_t>(triangulo.nnz()));
+    A.values.reserve(2 * static_cast<size_t>(triangulo.nnz()));
+    for (int i = 1; i <= A.linhas; ++i) {
+        for (int k = triangulo.row_ptr[i - 1]; k < triangulo.row_ptr[i]; ++k) {
+            A.col_idx.push_back(triangulo.col_idx[k]);
+            A.values.push_back(triangulo.values[k]);
+        }
+        for (int k = superior.row_ptr[i - 1]; k < superior.row_ptr[i]; ++k) {
+            if (superior.col_idx[k] == i) continue;
+            A.col_idx.push_back(superior.col_idx[k]);
+            A.values.push_back(sinal * superior.values[k]);
+        }
+        A.row_ptr[i] = static_cast<int>(A.col_idx.size());
+    }
+    return A;
+}
+
+/* Compara a matriz com a sua transposta, elemento a elemento
+ * As duas precisam ter exatamente as mesmas posições; a matriz é simétrica se os valores forem iguais
+ * e antissimétrica se forem opostos (como só há elementos não nulos, a diagonal fica vazia)
+ */
+Simetria detectarSimetria(const CSRView& A) {
+    if (A.linhas != A.colunas) {
+        return Simetria::Geral;
+    }
+    CSRMatrix T = transpor(A);
+    if (!equal(T.row_ptr.begin(), T.row_ptr.end(), A.row_ptr) || !equal(T.col_idx.begin(), T.col_idx.end(), A.col_idx)) {
+        return Simetria::Geral;
+    }
+    if (equal(T.values.begin(), T.values.end(), A.values)) {
+        return Simetria::Simetrica;
+    }
+    for (int k = 0; k < A.nnz(); ++k) {
+        if (T.values[k] != -A.values[k]) return Simetria::Geral;
+    }
+    return Simetria::AntiSimetrica;
+}
+
+#define INSTANCIAR(T, Index)                                                    \
+    template struct CSRViewT<T, Index>;                                          \
+    template CSRMatrixT<T, Index> transpor(const CSRViewT<T, Index>& A);
+PARA_CADA_TIPO_MATRIZ(INSTANCIAR)
@@ -0,0 +1,75 @@
+#ifndef CSR_MATRIX_H
+#define CSR_MATRIX_H
+
+#include <cstddef>
+#include <vector>
+
+// Definição da estrutura CSRMatrixT, representação comprimida por linhas de uma matriz esparsa
+// Os elementos da linha i ocupam as posições [row_ptr[i - 1], row_ptr[i]) de col_idx e values,
+// em ordem crescente de coluna. Os índices de linha e coluna começam em 1, como em Node.
+// A mesma estrutura representa a forma comprimida por colunas (CSC) de uma matriz
+// quando guarda a sua transposta. Os valores são do tipo T e os índices do tipo Index.
+template <typename T, typename Index>
+struct CSRMatrixT {
+    Index linhas = 0, colunas = 0; // Dimensões da matriz
+    std::vector<Index> row_ptr;    // Início de cada linha em col_idx/values (linhas + 1 posições)
+    std::vector<Index> col_idx;    // Coluna de cada elemento não nulo
+    std::vector<T> values;         // Valor de cada elemento não nulo
+
+    // Retorna a quantidade de elementos não nulos
+    Index nnz() const { return static_cast<Index>(values.size()); }
+
+    // Retorna a quantidade de bytes ocupados pelos vetores
+    std::size_t bytes() const {
+        return (row_ptr.size() + col_idx.size()) * sizeof(Index) + values.size() * sizeof(T);
+    }
+};
+
+// Definição da estrutura CSRViewT, acesso somente leitura a uma matriz na forma CSR
+// Não é dona dos vetores: eles podem pertencer a uma CSRMatrix ou a um arquivo mapeado na memória,
+// que precisam continuar existindo enquanto a visão for usada
+template <typename T, typename Index>
+struct CSRViewT {
+    Index linhas = 0, colunas = 0;
+    const Index* row_ptr = nullptr;
+    const Index* col_idx = nullptr;
+    const T* values = nullptr;
+
+    CSRViewT() = default;
+
+    // Cria uma visão dos vetores de uma CSRMatrixT
+    CSRViewT(const CSRMatrixT<T, Index>& csr)
+        : linhas(csr.linhas), colunas(csr.colunas), row_ptr(csr.row_ptr.data()),
+          col_idx(csr.col_idx.data()), values(csr.values.data()) {}
+
+    // Retorna a quantidade de elementos não nulos
+    Index nnz() const { return row_ptr ? row_ptr[linhas] : 0; }
+
+    // Retorna o valor armazenado em (i, j), ou 0 se não existir
+    T get(Index i, Index j) const;
+};
+
+// Formas comprimidas da matriz usada pelo programa: valores double e índices int
+using CSRMatrix = CSRMatrixT<double, int>;
+using CSRView = CSRViewT<double, int>;
+
+// Retorna a transposta de uma matriz CSR, que é também a sua forma CSC
+template <typename T, typename Index>
+CSRMatrixT<T, Index> transpor(const CSRViewT<T, Index>& A);
+
+// Idem, a partir da própria CSRMatrixT (a dedução do template não considera a conversão para CSRViewT)
+template <typename T, typename Index>
+CSRMatrixT<T, Index> transpor(const CSRMatrixT<T, Index>& A) { return transpor(CSRViewT<T, Index>(A)); }
+
+// Simetria de uma matriz quadrada guardada apenas pelo triângulo inferior, com a diagonal, como no formato Matrix Market
+// Na simétrica, A(j, i) = A(i, j); na antissimétrica, A(j, i) = -A(i, j) e a diagonal é nula
+enum class Simetria { Geral, Simetrica, AntiSimetrica };
+
+// Monta a matriz completa a partir do seu triângulo inferior, espelhando os elementos fora da diagonal
+// Com Simetria::Geral, apenas copia a matriz; nas demais, lança uma exceção se houver elementos acima da diagonal
+CSRMatrix expandirSimetria(const CSRView& triangulo, Simetria simetria);
+
+// Compara a matriz com a sua transposta e retorna a sua simetria (Simetria::Geral se não for quadrada)
+Simetria detectarSimetria(const CSRView& A);
+
+#endif
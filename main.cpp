@@ -2,115 +2,125 @@
 // Yasmin de Lima Marques - 567615
 
 #include "sparse_matrix.h"
+#include "sparse_ops.h"
+#include "sparse_expr.h"
+#include "matrix_io.h"
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <map>
+#include <memory>
 #include <vector>
 #include <stdexcept>
 #include <string>
-#include <fstream>
 #include <limits>
 
 using namespace std;
 
+// Tempo de parede acumulado pelas execuções de um comando
+struct TempoComando {
+    long long execucoes = 0;
+    double totalMs = 0;
+    double maiorMs = 0;
+};
 
-/* Lê uma matriz esparsa de um arquivo e a armazena na estrutura
- * Abre o arquivo e verifica se foi carregado corretamente
- * Lê as dimensões da matriz e cria uma nova estrutura para armazená-la
- * Percorre o arquivo, lendo os elementos não nulos e inserindo-os na matriz
- * Fecha o arquivo após a leitura e exibe uma mensagem de sucesso.
- */
-void readSparseMatrix(SparseMatrix*& m, const string& nomeArquivo) {
-    ifstream file(nomeArquivo);
-
-    if(!file.is_open()) {
-        throw runtime_error("Erro ao abrir o arquivo.");
-    }
-
-    int linhas, colunas;
-    file >> linhas >> colunas;
+// Erro lançado por um nome de comando desconhecido, que não entra no tempo dos comandos da sessão
+struct ComandoInvalido : runtime_error {
+    ComandoInvalido() : runtime_error("Erro: Comando invalido. Digite 'help' para ver a lista de comandos.") {}
+};
 
-    delete m;
-    m = new SparseMatrix(linhas, colunas);
+// Estado do gerenciador de matrizes, compartilhado por todos os comandos
+struct Sessao {
+    vector<SparseMatrix*> matriz_list;
+    bool lote = false; // Modo em lote: os resultados são guardados sem perguntas e sem impressão
+    map<string, TempoComando> tempos; // Tempo de cada comando executado na sessão, pelo nome do comando
 
-    int i, j;
-    double valor;
-    while(file >> i >> j >> valor) {
-        if(valor != 0) {
-            m->inserir(i, j, valor);
+    ~Sessao() {
+        for(auto matriz : matriz_list) {
+            delete matriz;
         }
     }
+};
 
-    file.close();
-    cout << "Matriz de " << linhas << "x" << colunas << " carregada do arquivo " << nomeArquivo << ".\n";
+/* Lê uma matriz esparsa de um arquivo e a retorna por valor
+ * Carrega o arquivo de uma só vez pelo carregador em lote, que ordena os elementos
+ * e monta cada linha em uma única passada
+ * A matriz carregada é movida para o retorno, sem cópia; se a leitura falhar, a exceção é propagada
+ * Exibe uma mensagem de sucesso.
+ */
+SparseMatrix readSparseMatrix(const string& nomeArquivo) {
+    unique_ptr<SparseMatrix> m(loadSparseMatrix(nomeArquivo));
+    cout << "Matriz de " << m->getLinhas() << "x" << m->getColunas() << " carregada do arquivo " << nomeArquivo << ".\n";
+    return move(*m);
 }
 
-/* Soma duas matrizes esparsas e retorna uma nova matriz com o resultado
- * Verifica se as dimensões das matrizes são compatíveis, lançando uma exceção se não forem
- * Percorre a matriz A, copiando seus valores para a matriz resultado
- * Percorre a matriz B, somando seus valores aos já existentes na matriz resultado
- * Retorna a matriz resultante da soma
+/* Exibe os elementos não nulos da coluna j de uma matriz.
+ * Percorre somente os nós da coluna, sem visitar as demais linhas da matriz.
+ * Se a matriz estiver congelada, lê a coluna da forma CSC, ou consulta cada linha quando ela não existir.
+ * Informa quando a coluna não possui elementos não nulos.
  */
-SparseMatrix* sum(const SparseMatrix* A, const SparseMatrix* B) {
-    if(A->getLinhas() != B->getLinhas() || A->getColunas() != B->getColunas()) {
-        throw runtime_error("As matrizes tem dimensoes incompativeis para soma.");
-    }
-
-    SparseMatrix* C = new SparseMatrix(A->getLinhas(), A->getColunas());
-
-    Node* linha_sentinela = A->getHead()->abaixo;
-    for(int i = 1; i <= A->getLinhas(); ++i, linha_sentinela = linha_sentinela->abaixo) {
-        Node* linha_atual = linha_sentinela->direita;
-        while(linha_atual != linha_sentinela) {
-            C->inserir(linha_atual->linha, linha_atual->coluna, linha_atual->valor + B->get(linha_atual->linha, linha_atual->coluna));
-            linha_atual = linha_atual->direita;
+void showColumn(const SparseMatrix* A, int j) {
+    bool vazia = true;
+    if(A->isFrozen()) {
+        if(j < 1 || j > A->getColunas()) {
+            throw out_of_range("Erro: Indices fora dos limites da matriz.");
         }
-    }
-
-    linha_sentinela = B->getHead()->abaixo;
-    for(int i = 1; i <= B->getLinhas(); ++i, linha_sentinela = linha_sentinela->abaixo) {
-        Node* linha_atual = linha_sentinela->direita;
-        while(linha_atual != linha_sentinela) {
-            if(A->get(linha_atual->linha, linha_atual->coluna) == 0) { 
-                C->inserir(linha_atual->linha, linha_atual->coluna, linha_atual->valor);
+        const CSRView* csc = A->getCSC();
+        if(csc) {
+            for(int k = csc->row_ptr[j - 1]; k < csc->row_ptr[j]; ++k) {
+                cout << "(" << csc->col_idx[k] << ", " << j << ") = " << csc->values[k] << "\n";
+                vazia = false;
+            }
+        } else {
+            for(int i = 1; i <= A->getLinhas(); ++i) {
+                double valor = A->get(i, j);
+                if(valor != 0) {
+                    cout << "(" << i << ", " << j << ") = " << valor << "\n";
+                    vazia = false;
+                }
             }
-            linha_atual = linha_atual->direita;
+        }
+    } else {
+        for(const Node& elemento : A->coluna(j)) {
+            cout << "(" << elemento.linha << ", " << j << ") = " << elemento.valor << "\n";
+            vazia = false;
         }
     }
-
-    return C;
+    if(vazia) {
+        cout << "A coluna " << j << " nao possui elementos nao nulos.\n";
+    }
 }
 
-/* Multiplica duas matrizes esparsas e retorna uma nova matriz com o resultado.
- * Verifica se as dimensões das matrizes são compatíveis para multiplicação, lançando uma exceção se não forem.
- * Cria uma nova matriz esparsa para armazenar o resultado.
- * Percorre os elementos não nulos da matriz A.
- * Para cada elemento de A, percorre a linha correspondente em B para calcular os produtos.
- * Acumula os valores resultantes na matriz C, garantindo que apenas elementos não nulos sejam armazenados.
- * Retorna a matriz resultante da multiplicação.
+/* Lança a exceção de argumentos ausentes ou inválidos de um comando
+ * Antes, limpa o estado de erro da entrada e descarta o restante da linha, para que o próximo comando
+ * seja lido normalmente no modo interativo
  */
+[[noreturn]] void argumentosInvalidos(istream& entrada) {
+    entrada.clear();
+    entrada.ignore(numeric_limits<streamsize>::max(), '\n');
+    throw invalid_argument("Erro: Argumentos ausentes ou invalidos.");
+}
 
-SparseMatrix* multiply(const SparseMatrix* A, const SparseMatrix* B) {
-    if(A->getColunas() != B->getLinhas()) {
-        throw runtime_error("As matrizes tem dimensoes incompativeis para multiplicacao.");
-    }
-
-    SparseMatrix* C = new SparseMatrix(A->getLinhas(), B->getColunas());
-
-    for(Node* linhaA = A->getHead()->abaixo; linhaA != A->getHead(); linhaA = linhaA->abaixo) {
-        for(Node* elementoA = linhaA->direita; elementoA != linhaA; elementoA = elementoA->direita) {
-            Node* linhaB = B->getHead()->abaixo;
-            for(int k = 1; k < elementoA->coluna; ++k) {
-                linhaB = linhaB->abaixo;
-            }
-            for(Node* elementoB = linhaB->direita; elementoB != linhaB; elementoB = elementoB->direita) {
-                double valor = elementoA->valor * elementoB->valor;
-                if (valor != 0) {
-                    C->inserir(elementoA->linha, elementoB->coluna, C->get(elementoA->linha, elementoB->coluna) + valor);
-                }
-            }
+/* Lê um vetor de n valores da entrada, multiplica-o pela matriz (ou pela sua transposta)
+ * e exibe o vetor resultante.
+ */
+void showMatrixVector(const SparseMatrix* A, bool transposta, istream& entrada) {
+    int n = transposta ? A->getLinhas() : A->getColunas();
+    vector<double> x(n);
+    for(double& valor : x) {
+        if(!(entrada >> valor)) {
+            argumentosInvalidos(entrada);
         }
     }
 
-    return C;
+    vector<double> y = transposta ? multiplyTransposeVector(A, x) : multiplyVector(A, x);
+    cout << "Resultado: [";
+    for(size_t i = 0; i < y.size(); ++i) {
+        cout << y[i] << (i + 1 < y.size() ? ", " : "");
+    }
+    cout << "]\n";
 }
 
 /* Exibe os índices das matrizes armazenadas na lista.
@@ -132,6 +142,78 @@ void showIndexes(const vector<SparseMatrix*>& matriz_list) {
     cout << endl;
 }
 
+/* Exibe o uso de memória e os contadores de uma matriz.
+ * Os contadores de percurso só aparecem se o programa foi compilado com -DSPARSE_PROFILING.
+ */
+void showPerfilMatriz(const SparseMatrix* A) {
+    const ContadoresAlocacao& alocacao = A->getContadoresAlocacao();
+    cout << "Memoria: " << A->bytesResidentes() << " bytes | nos alocados: " << alocacao.alocados
+         << " | liberados: " << alocacao.liberados << " | reutilizados: " << alocacao.reutilizados
+         << " | blocos: " << alocacao.blocos << "\n";
+    if(PERFIL_ATIVO) {
+        ContadoresPercurso percurso = A->getContadoresPercurso();
+        cout << "Saltos: " << percurso.saltos << " | consultas: " << percurso.consultas
+             << " | insercoes: " << percurso.insercoes << " | remocoes: " << percurso.remocoes
+             << " | religacoes das colunas: " << percurso.religacoes << "\n";
+    }
+}
+
+/* Exibe o tempo de parede de cada comando executado na sessão e a memória de cada matriz.
+ * Para cada comando, mostra quantas vezes ele foi executado, o tempo total, o médio e o maior.
+ */
+void showPerfilSessao(const Sessao& sessao) {
+    if(sessao.tempos.empty()) {
+        cout << "Nenhum comando executado.\n";
+    }
+    cout << fixed << setprecision(3);
+    for(const auto& [nome, tempo] : sessao.tempos) {
+        cout << left << setw(14) << nome << right << setw(6) << tempo.execucoes << "x | total: "
+             << setw(10) << tempo.totalMs << " ms | medio: " << setw(9) << tempo.totalMs / tempo.execucoes
+             << " ms | maior: " << setw(9) << tempo.maiorMs << " ms\n";
+    }
+    cout << defaultfloat;
+    for(size_t i = 0; i < sessao.matriz_list.size(); ++i) {
+        cout << "Matriz " << i << " (" << sessao.matriz_list[i]->getLinhas() << "x"
+             << sessao.matriz_list[i]->getColunas() << "): ";
+        showPerfilMatriz(sessao.matriz_list[i]);
+    }
+    if(!PERFIL_ATIVO) {
+        cout << "Compile com -DSPARSE_PROFILING para contar os saltos e as consultas de cada matriz.\n";
+    }
+}
+
+/* Grava em JSON o tempo de cada comando da sessão e a memória e os contadores de cada matriz,
+ * para comparação entre execuções e versões do programa.
+ */
+void gravarPerfilJSON(ostream& saida, const Sessao& sessao) {
+    saida << setprecision(6) << defaultfloat;
+    saida << "{\n"
+          << "  \"instrumentacao\": " << (PERFIL_ATIVO ? "true" : "false") << ",\n"
+          << "  \"comandos\": [\n";
+    size_t k = 0;
+    for(const auto& [nome, tempo] : sessao.tempos) {
+        saida << "    {\"comando\": \"" << nome << "\", \"execucoes\": " << tempo.execucoes
+              << ", \"total_ms\": " << tempo.totalMs << ", \"maior_ms\": " << tempo.maiorMs << "}"
+              << (++k < sessao.tempos.size() ? "," : "") << "\n";
+    }
+    saida << "  ],\n"
+          << "  \"matrizes\": [\n";
+    for(size_t i = 0; i < sessao.matriz_list.size(); ++i) {
+        const SparseMatrix* A = sessao.matriz_list[i];
+        const ContadoresAlocacao& alocacao = A->getContadoresAlocacao();
+        ContadoresPercurso percurso = A->getContadoresPercurso();
+        saida << "    {\"indice\": " << i << ", \"linhas\": " << A->getLinhas() << ", \"colunas\": " << A->getColunas()
+              << ", \"nnz\": " << A->countNonZero() << ", \"bytes\": " << A->bytesResidentes()
+              << ", \"nos_alocados\": " << alocacao.alocados << ", \"nos_liberados\": " << alocacao.liberados
+              << ", \"nos_reutilizados\": " << alocacao.reutilizados << ", \"blocos\": " << alocacao.blocos
+              << ", \"saltos\": " << percurso.saltos << ", \"consultas\": " << percurso.consultas
+              << ", \"insercoes\": " << percurso.insercoes << ", \"remocoes\": " << percurso.remocoes
+              << ", \"religacoes\": " << percurso.religacoes << "}"
+              << (i + 1 < sessao.matriz_list.size() ? "," : "") << "\n";
+    }
+    saida << "  ]\n}\n";
+}
+
 // Exibe os comandos disponíveis
 void helper() {
     cout << "----------------------------------------------------------------------------\n";
@@ -140,194 +222,623 @@ void helper() {
     cout << "exit ...................................................... fechar o progrma\n";
     cout << "create m n .................. criar uma nova matriz com m linhas e n colunas\n";
     cout << "show i ............................... imprimir a matriz i no terminal print\n";
+    cout << "showall i .......................... imprimir a matriz i mesmo se for grande\n";
+    cout << "head i k .............. resumo da matriz i com os seus k primeiros elementos\n";
     cout << "showidx ......................... .... mostrar todos os indices das matrizes\n";
     cout << "sum i j ............................. somar as matrizes i e j da matriz_list\n";
     cout << "multiply i j .................. multiplicar as matrizes i e j da matriz_list\n";
+    cout << "multiplyfile 'a' 'b' 'c' mb ...... produto a * b em blocos em 'c', com mb MB\n";
+    cout << "axpy i alpha j .. somar alpha vezes a matriz j na matriz i, no proprio lugar\n";
+    cout << "muladd k i j ...... somar o produto das matrizes i e j na matriz k, no lugar\n";
+    cout << "spmv i x1 ... xn ............... multiplicar a matriz i pelo vetor x (A * x)\n";
+    cout << "spmvt i x1 ... xm ........ multiplicar a transposta da matriz i pelo vetor x\n";
+    cout << "transpose i ............................................ transpor a matriz i\n";
+    cout << "gram i ............. A^T * A da matriz i, calculando so o triangulo superior\n";
+    cout << "gramt i ............ A * A^T da matriz i, calculando so o triangulo superior\n";
+    cout << "column i j .................... mostrar os elementos da coluna j da matriz i\n";
+    cout << "freeze i ......................... congelar a matriz i na forma compacta CSR\n";
+    cout << "thaw i .................................. descongelar a matriz i para edicao\n";
     cout << "clear i ................................................... zerar a matriz i\n";
     cout << "read 'm.txt' ............ ler uma matriz esparsa do arquivo com nome 'm.txt'\n";
+    cout << "read 'm.mtx' ............... ler uma matriz do arquivo Matrix Market 'm.mtx'\n";
+    cout << "save i 'm.spm' ................ gravar a matriz i no arquivo binario 'm.spm'\n";
+    cout << "export i 'm.mtx' ...... gravar em texto os nao nulos (Matrix Market se .mtx)\n";
+    cout << "load 'm.spm' ......... abrir congelada uma matriz do arquivo binario 'm.spm'\n";
     cout << "count i .................... contar quantos elementos não nulos há na matriz\n";
+    cout << "stats i ............ estatisticas da matriz i: nnz, linhas, banda, densidade\n";
+    cout << "stats ............. tempo de cada comando da sessao e memoria de cada matriz\n";
+    cout << "statsjson 'p.json' ..... gravar o tempo dos comandos e os contadores em JSON\n";
     cout << "update m i j value ........... atualizar o valor da célula (i,j) na matriz m\n";
+    cout << "prune i eps ........ remover da matriz i os elementos com |valor| <= eps\n";
+    cout << "threads n ...................... usar n threads nas operacoes sum e multiply\n";
     cout << "eraseAll .............................. apagar todas as matrizes do programa\n";
     cout << "----------------------------------------------------------------------------\n";
 }
 
-int main() {
-    vector<SparseMatrix*> matriz_list;
-    string comando;
+/* Guarda na lista de matrizes o resultado de uma operação.
+ * No modo interativo, imprime o resultado e pergunta se ele deve ser guardado, lendo a resposta da entrada.
+ * No modo em lote, guarda o resultado sem imprimi-lo e sem perguntar.
+ */
+void guardarResultado(Sessao& sessao, SparseMatrix* resultado, const string& titulo, istream& entrada) {
+    if(!sessao.lote) {
+        cout << titulo << "\n";
+        resultado->print();
+
+        cout << "Deseja salvar o resultado? (s/n): ";
+        char resposta = 'n';
+        entrada >> resposta;
+
+        if(resposta != 's' && resposta != 'S') {
+            delete resultado;
+            return;
+        }
+    }
+    sessao.matriz_list.push_back(resultado);
+    cout << "Matriz resultado salva como indice " << sessao.matriz_list.size() - 1 << ".\n";
+}
 
-    cout << "Bem-vindo ao gerenciador de Matrizes Esparsas!\n";
-    cout << "Digite 'help' para ver os comandos disponíveis.\n";
+/* Executa um comando, lendo os seus argumentos da entrada.
+ * Retorna falso se o comando pedir o fim do programa. Índices inválidos e comandos desconhecidos lançam exceções,
+ * contadas como falhas no modo em lote.
+ */
+bool executarComando(Sessao& sessao, const string& comando, istream& entrada) {
+    vector<SparseMatrix*>& matriz_list = sessao.matriz_list;
 
-    while(true) {
-        cout << "\n>> ";
-        cin >> comando;
+    // Comando para sair do programa
+    if(comando == "exit") {
+        cout << "Saindo do programa...\n";
+        return false;
+    }
+    // Comando para exibir os comandos disponíveis
+    else if(comando == "help") {
+        helper();
+    }
+    // Comando para criar uma nova matriz
+    else if(comando == "create") {
+        int linhas, colunas;
+        if(!(entrada >> linhas >> colunas)) {
+            argumentosInvalidos(entrada);
+        }
+        matriz_list.push_back(new SparseMatrix(linhas, colunas));
+        cout << "Matriz adicionada! Indice: " << matriz_list.size() - 1 << "\n";
+    }
+    // Comando para ler uma matriz de um arquivo
+    else if(comando == "read") {
+        string nomeArquivo;
+        if(!(entrada >> nomeArquivo)) {
+            argumentosInvalidos(entrada);
+        }
 
         try {
-            // Comando para sair do programa
-            if(comando == "exit") {
-                cout << "Saindo do programa...\n";
-                break;
-            }
-            // Comando para exibir os comandos disponíveis
-            else if(comando == "help") {
-                helper();
-            }
-            // Comando para criar uma nova matriz
-            else if(comando == "create") {
-                int linhas, colunas;
-                cin >> linhas >> colunas;
-                matriz_list.push_back(new SparseMatrix(linhas, colunas));
-                cout << "Matriz adicionada! Indice: " << matriz_list.size() - 1 << "\n";
-            }
-            // Comando para ler uma matriz de um arquivo
-            else if(comando == "read") {
-                string nomeArquivo;
-                cin >> nomeArquivo;
-
-                SparseMatrix* matriz = new SparseMatrix(1, 1);
-                try {
-                    readSparseMatrix(matriz, nomeArquivo);
-                    matriz_list.push_back(matriz);
-                } catch(const exception& e) {
-                    cerr << "Erro ao ler arquivo: " << e.what() << endl;
-                    delete matriz;
-                }
-            }
-            // Comando para exibir os índices das matrizes armazenadas
-            else if(comando == "showidx") {
-                cout << "Indices das matrizes: ";
-                showIndexes(matriz_list);
-            }
-            // Comando para exibir uma matriz específica
-            else if(comando == "show") {
-                int index;
-                cin >> index;
-                if(index < 0 || index >= static_cast<int>(matriz_list.size())) {
-                    throw out_of_range("Erro: Indice invalido.");
-                } else {
-                    cout << "Imprimindo matriz[" << index << "]:\n";
-                    matriz_list[index]->print();
-                }
-            }
-            // Comando para somar duas matrizes
-            else if(comando == "sum") {
-                int indice1, indice2;
-                cin >> indice1 >> indice2;
-
-                if(indice1 < 0 || indice1 >= static_cast<int>(matriz_list.size()) ||
-                    indice2 < 0 || indice2 >= static_cast<int>(matriz_list.size())) {
-                    throw out_of_range("Erro: Indice invalido.");
-                    continue;
-                }
+            matriz_list.push_back(new SparseMatrix(readSparseMatrix(nomeArquivo)));
+        } catch(const exception& e) {
+            if(sessao.lote) throw;
+            cerr << "Erro ao ler arquivo: " << e.what() << endl;
+        }
+    }
+    // Comando para gravar uma matriz no formato binário
+    else if(comando == "save") {
+        int index;
+        string nomeArquivo;
+        if(!(entrada >> index >> nomeArquivo)) {
+            argumentosInvalidos(entrada);
+        }
 
-                try {
-                    SparseMatrix* resultado = sum(matriz_list[indice1], matriz_list[indice2]);
-                    cout << "Resultado da soma:\n";
-                    resultado->print();
+        if(index < 0 || index >= static_cast<int>(matriz_list.size())) {
+            throw out_of_range("Erro: Indice invalido.");
+        }
 
-                    cout << "Deseja salvar o resultado? (s/n): ";
-                    char resposta;
-                    cin >> resposta;
+        saveBinary(matriz_list[index], nomeArquivo);
+        cout << "Matriz " << index << " gravada no arquivo " << nomeArquivo << ".\n";
+    }
+    // Comando para gravar os elementos não nulos de uma matriz em um arquivo texto
+    // Arquivos terminados em .mtx são gravados no formato Matrix Market, só com o triângulo inferior se a matriz
+    // for simétrica; os demais, em triplas, como lidos por read
+    else if(comando == "export") {
+        int index;
+        string nomeArquivo;
+        if(!(entrada >> index >> nomeArquivo)) {
+            argumentosInvalidos(entrada);
+        }
 
-                    if (resposta == 's' || resposta == 'S') {
-                        matriz_list.push_back(resultado);
-                        cout << "Matriz resultado salva como indice " << matriz_list.size() - 1 << ".\n";
-                    } else {
-                        delete resultado;
-                    }
-                } catch(const exception& e) {
-                    cerr << "Erro: " << e.what() << endl;
-                }
+        if(index < 0 || index >= static_cast<int>(matriz_list.size())) {
+            throw out_of_range("Erro: Indice invalido.");
+        }
+
+        bool mtx = nomeArquivo.size() >= 4 && nomeArquivo.compare(nomeArquivo.size() - 4, 4, ".mtx") == 0;
+        if(mtx) {
+            saveMatrixMarket(matriz_list[index], nomeArquivo);
+        } else {
+            saveSparseMatrix(matriz_list[index], nomeArquivo, FormatoTexto::Triplas);
+        }
+        cout << "Matriz " << index << " exportada para o arquivo " << nomeArquivo << ".\n";
+    }
+    // Comando para abrir uma matriz gravada no formato binário, já congelada
+    else if(comando == "load") {
+        string nomeArquivo;
+        if(!(entrada >> nomeArquivo)) {
+            argumentosInvalidos(entrada);
+        }
+
+        try {
+            SparseMatrix* matriz = openBinary(nomeArquivo);
+            matriz_list.push_back(matriz);
+            cout << "Matriz de " << matriz->getLinhas() << "x" << matriz->getColunas() << " aberta do arquivo "
+                 << nomeArquivo << " (indice " << matriz_list.size() - 1 << ", congelada).\n";
+        } catch(const exception& e) {
+            if(sessao.lote) throw;
+            cerr << "Erro ao ler arquivo: " << e.what() << endl;
+        }
+    }
+    // Comando para exibir os índices das matrizes armazenadas
+    else if(comando == "showidx") {
+        cout << "Indices das matrizes: ";
+        showIndexes(matriz_list);
+    }
+    // Comando para exibir uma matriz específica
+    else if(comando == "show") {
+        int index;
+        if(!(entrada >> index)) {
+            argumentosInvalidos(entrada);
+        }
+        if(index < 0 || index >= static_cast<int>(matriz_list.size())) {
+            throw out_of_range("Erro: Indice invalido.");
+        } else {
+            cout << "Imprimindo matriz[" << index << "]:\n";
+            matriz_list[index]->print();
+        }
+    }
+    // Comando para exibir uma matriz específica mesmo acima do limite da impressão densa
+    else if(comando == "showall") {
+        int index;
+        if(!(entrada >> index)) {
+            argumentosInvalidos(entrada);
+        }
+        if(index < 0 || index >= static_cast<int>(matriz_list.size())) {
+            throw out_of_range("Erro: Indice invalido.");
+        }
+        cout << "Imprimindo matriz[" << index << "]:\n";
+        matriz_list[index]->print(true);
+    }
+    // Comando para exibir o resumo de uma matriz e os seus primeiros elementos
+    else if(comando == "head") {
+        int index, k;
+        if(!(entrada >> index >> k)) {
+            argumentosInvalidos(entrada);
+        }
+        if(index < 0 || index >= static_cast<int>(matriz_list.size())) {
+            throw out_of_range("Erro: Indice invalido.");
+        }
+        matriz_list[index]->printSummary(k);
+    }
+    // Comando para somar duas matrizes
+    else if(comando == "sum") {
+        int indice1, indice2;
+        if(!(entrada >> indice1 >> indice2)) {
+            argumentosInvalidos(entrada);
+        }
+
+        if(indice1 < 0 || indice1 >= static_cast<int>(matriz_list.size()) ||
+            indice2 < 0 || indice2 >= static_cast<int>(matriz_list.size())) {
+            throw out_of_range("Erro: Indice invalido.");
+        }
+
+        try {
+            guardarResultado(sessao, sum(matriz_list[indice1], matriz_list[indice2]), "Resultado da soma:", entrada);
+        } catch(const exception& e) {
+            if(sessao.lote) throw;
+            cerr << "Erro: " << e.what() << endl;
+        }
+    }
+    // Comando para multiplicar duas matrizes
+    else if(comando == "multiply") {
+        int indice1, indice2;
+        if(!(entrada >> indice1 >> indice2)) {
+            argumentosInvalidos(entrada);
+        }
+
+        if(indice1 < 0 || indice1 >= static_cast<int>(matriz_list.size()) ||
+            indice2 < 0 || indice2 >= static_cast<int>(matriz_list.size())) {
+            throw out_of_range("Erro: Indices invalidos.");
+        }
+
+        try {
+            guardarResultado(sessao, multiply(matriz_list[indice1], matriz_list[indice2]), "Resultado da multiplicacao:", entrada);
+        } catch(const exception& e) {
+            if(sessao.lote) throw;
+            cerr << "Erro: " << e.what() << endl;
+        }
+    }
+    // Comando para multiplicar em blocos duas matrizes gravadas no formato binário
+    else if(comando == "multiplyfile") {
+        string arquivoA, arquivoB, arquivoC;
+        size_t megabytes;
+        if(!(entrada >> arquivoA >> arquivoB >> arquivoC >> megabytes)) {
+            argumentosInvalidos(entrada);
+        }
+
+        long long nnz = multiplyStreaming(arquivoA, arquivoB, arquivoC, megabytes << 20);
+        cout << "Produto gravado no arquivo " << arquivoC << " (" << nnz << " elementos nao nulos).\n";
+    }
+    // Comando para somar alpha * j na matriz i, sem criar uma nova matriz
+    else if(comando == "axpy") {
+        int indice1, indice2;
+        double alpha;
+        if(!(entrada >> indice1 >> alpha >> indice2)) {
+            argumentosInvalidos(entrada);
+        }
+
+        if(indice1 < 0 || indice1 >= static_cast<int>(matriz_list.size()) ||
+            indice2 < 0 || indice2 >= static_cast<int>(matriz_list.size())) {
+            throw out_of_range("Erro: Indices invalidos.");
+        }
+
+        matriz_list[indice1]->axpy(alpha, *matriz_list[indice2]);
+        cout << "Matriz " << indice1 << " atualizada.\n";
+    }
+    // Comando para somar o produto i * j na matriz k, sem criar a matriz do produto
+    else if(comando == "muladd") {
+        int indice, indice1, indice2;
+        if(!(entrada >> indice >> indice1 >> indice2)) {
+            argumentosInvalidos(entrada);
+        }
+
+        if(indice < 0 || indice >= static_cast<int>(matriz_list.size()) ||
+            indice1 < 0 || indice1 >= static_cast<int>(matriz_list.size()) ||
+            indice2 < 0 || indice2 >= static_cast<int>(matriz_list.size())) {
+            throw out_of_range("Erro: Indices invalidos.");
+        }
+
+        try {
+            *matriz_list[indice] += expressao(*matriz_list[indice1]) * expressao(*matriz_list[indice2]);
+            cout << "Matriz " << indice << " atualizada.\n";
+        } catch(const exception& e) {
+            if(sessao.lote) throw;
+            cerr << "Erro: " << e.what() << endl;
+        }
+    }
+    // Comando para multiplicar uma matriz, ou a sua transposta, por um vetor
+    else if(comando == "spmv" || comando == "spmvt") {
+        int index;
+        if(!(entrada >> index)) {
+            argumentosInvalidos(entrada);
+        }
+
+        if(index < 0 || index >= static_cast<int>(matriz_list.size())) {
+            entrada.ignore(numeric_limits<streamsize>::max(), '\n');
+            throw out_of_range("Erro: Indice invalido.");
+        }
+
+        showMatrixVector(matriz_list[index], comando == "spmvt", entrada);
+    }
+    // Comando para transpor uma matriz
+    else if(comando == "transpose") {
+        int index;
+        if(!(entrada >> index)) {
+            argumentosInvalidos(entrada);
+        }
+
+        if(index < 0 || index >= static_cast<int>(matriz_list.size())) {
+            throw out_of_range("Erro: Indice invalido.");
+        }
+
+        guardarResultado(sessao, transpose(matriz_list[index]), "Resultado da transposicao:", entrada);
+    }
+    // Comando para calcular A^T * A ou A * A^T, aproveitando a simetria do resultado
+    else if(comando == "gram" || comando == "gramt") {
+        int index;
+        if(!(entrada >> index)) {
+            argumentosInvalidos(entrada);
+        }
+
+        if(index < 0 || index >= static_cast<int>(matriz_list.size())) {
+            throw out_of_range("Erro: Indice invalido.");
+        }
+
+        SparseMatrix* resultado = comando == "gram" ? multiplyATA(matriz_list[index]) : multiplyAAT(matriz_list[index]);
+        guardarResultado(sessao, resultado, comando == "gram" ? "Resultado de A^T * A:" : "Resultado de A * A^T:", entrada);
+    }
+    // Comando para exibir uma coluna de uma matriz
+    else if(comando == "column") {
+        int index, j;
+        if(!(entrada >> index >> j)) {
+            argumentosInvalidos(entrada);
+        }
+
+        if(index < 0 || index >= static_cast<int>(matriz_list.size())) {
+            throw out_of_range("Erro: Indice invalido.");
+        }
+
+        showColumn(matriz_list[index], j);
+    }
+    // Comando para congelar uma matriz na forma compacta
+    else if(comando == "freeze") {
+        int index;
+        if(!(entrada >> index)) {
+            argumentosInvalidos(entrada);
+        }
+
+        if(index < 0 || index >= static_cast<int>(matriz_list.size())) {
+            throw out_of_range("Erro: Indice invalido.");
+        }
+
+        matriz_list[index]->freeze(true);
+        cout << "Matriz " << index << " congelada (" << matriz_list[index]->countNonZero() << " elementos nao nulos).\n";
+    }
+    // Comando para descongelar uma matriz
+    else if(comando == "thaw") {
+        int index;
+        if(!(entrada >> index)) {
+            argumentosInvalidos(entrada);
+        }
+
+        if(index < 0 || index >= static_cast<int>(matriz_list.size())) {
+            throw out_of_range("Erro: Indice invalido.");
+        }
+
+        matriz_list[index]->thaw();
+        cout << "Matriz " << index << " descongelada.\n";
+    }
+    // Comando para atualizar um valor na matriz
+    else if (comando == "update") {
+        int index, i, j;
+        double valor;
+        if(!(entrada >> index >> i >> j >> valor)) {
+            argumentosInvalidos(entrada);
+        }
+
+        if(index < 0 || index >= static_cast<int>(matriz_list.size())) {
+            throw out_of_range("Erro: Indice invalido.");
+        }
+        matriz_list[index]->inserir(i, j, valor);
+        cout << (valor == 0 ? "Elemento removido da matriz.\n" : "Valor atualizado na matriz.\n");
+    }
+    // Comando para remover os elementos de valor absoluto até eps, como restos de cancelamentos
+    else if(comando == "prune") {
+        int index;
+        double epsilon;
+        if(!(entrada >> index >> epsilon)) {
+            argumentosInvalidos(entrada);
+        }
+
+        if(index < 0 || index >= static_cast<int>(matriz_list.size())) {
+            throw out_of_range("Erro: Indice invalido.");
+        }
+        int removidos = matriz_list[index]->prune(epsilon);
+        cout << removidos << " elementos removidos da matriz " << index << ".\n";
+    }
+    // Comando para limpar uma matriz
+    else if(comando == "clear") {
+        int index;
+        if(!(entrada >> index)) {
+            argumentosInvalidos(entrada);
+        }
+
+        if(index < 0 || index >= static_cast<int>(matriz_list.size())) {
+            throw out_of_range("Erro: Indice invalido.");
+        }
+
+        matriz_list[index]->clear(); // Suposição de que existe um método clear() na classe SparseMatrix
+        cout << "Matriz " << index << " foi zerada.\n";
+    }
+    // Comando para contar quantos elementos não nulos tem na matriz
+    else if (comando == "count") {
+        int index;
+        if(!(entrada >> index)) {
+            argumentosInvalidos(entrada);
+        }
+
+        if (index < 0 || index >= static_cast<int>(matriz_list.size())) {
+            throw out_of_range("Erro: Indice invalido.");
+        }
+
+        cout << "A matriz contem " << matriz_list[index]->countNonZero() << " elementos nao nulos.\n";
+    }
+    // Comando para exibir as estatísticas da estrutura de uma matriz
+    else if(comando == "stats") {
+        string resto;
+        getline(entrada, resto);
+        istringstream argumentos(resto);
+        int index;
+        if(!(argumentos >> index)) {
+            if(resto.find_first_not_of(" \t\r") != string::npos) {
+                throw invalid_argument("Erro: Argumentos ausentes ou invalidos.");
             }
-            // Comando para multiplicar duas matrizes
-            else if(comando == "multiply") {
-                int indice1, indice2;
-                cin >> indice1 >> indice2;
-
-                if(indice1 < 0 || indice1 >= static_cast<int>(matriz_list.size()) ||
-                    indice2 < 0 || indice2 >= static_cast<int>(matriz_list.size())) {
-                    cout << "Indices invalidos.\n";
-                    continue;
-                }
+            showPerfilSessao(sessao);
+            return true;
+        }
+        if(index < 0 || index >= static_cast<int>(matriz_list.size())) {
+            throw out_of_range("Erro: Indice invalido.");
+        }
+        EstatisticasMatriz e = matriz_list[index]->getEstatisticas();
+        cout << "Matriz " << e.linhas << "x" << e.colunas << ": " << e.nnz << " elementos nao nulos\n"
+             << "Maior linha: " << e.maxLinha << " | maior coluna: " << e.maxColuna
+             << " | media por linha: " << e.mediaLinha << "\n"
+             << "Banda: " << e.banda << " | densidade: " << e.densidade << "\n";
+        showPerfilMatriz(matriz_list[index]);
+    }
+    // Comando para gravar em JSON o tempo dos comandos e os contadores das matrizes
+    else if(comando == "statsjson") {
+        string nomeArquivo;
+        if(!(entrada >> nomeArquivo)) {
+            argumentosInvalidos(entrada);
+        }
+        ofstream saida(nomeArquivo);
+        if(!saida.is_open()) {
+            throw runtime_error("Erro ao abrir o arquivo.");
+        }
+        gravarPerfilJSON(saida, sessao);
+        cout << "Perfil da sessao gravado no arquivo " << nomeArquivo << ".\n";
+    }
+    // Comando para definir quantas threads as operações usam
+    else if(comando == "threads") {
+        int n;
+        if(!(entrada >> n)) {
+            argumentosInvalidos(entrada);
+        }
+        setNumThreads(n);
+        cout << "Operacoes usando " << getNumThreads() << " thread(s).\n";
+    }
+    // Comando para apagar todas as matrizes
+    else if(comando == "eraseAll") {
+        for(auto& matriz : matriz_list) {
+            delete matriz;
+        }
+        matriz_list.clear();
+        cout << "Todas as matrizes foram apagadas.\n";
+    } 
+    else {
+        entrada.ignore(numeric_limits<streamsize>::max(), '\n'); // Ignora o restante da linha
+        throw ComandoInvalido();
+    }
+    return true;
+}
 
-                try {
-                    SparseMatrix* resultado = multiply(matriz_list[indice1], matriz_list[indice2]);
-                    cout << "Resultado da multiplicacao:\n";
-                    resultado->print();
+/* Executa um comando e acumula o seu tempo de parede na sessão, pelo nome do comando.
+ * O tempo é acumulado mesmo que o comando falhe, exceto se o nome do comando for desconhecido;
+ * em "ms" fica o tempo desta execução.
+ * Retorna o mesmo que executarComando.
+ */
+bool executarMedindo(Sessao& sessao, const string& comando, istream& entrada, double& ms) {
+    auto inicio = chrono::steady_clock::now();
+    auto registrar = [&]() {
+        ms = chrono::duration<double, milli>(chrono::steady_clock::now() - inicio).count();
+        TempoComando& tempo = sessao.tempos[comando];
+        tempo.execucoes++;
+        tempo.totalMs += ms;
+        tempo.maiorMs = max(tempo.maiorMs, ms);
+    };
+
+    bool continuar;
+    try {
+        continuar = executarComando(sessao, comando, entrada);
+    } catch(const ComandoInvalido&) {
+        throw;
+    } catch(...) {
+        registrar();
+        throw;
+    }
+    registrar();
+    return continuar;
+}
+/* Executa os comandos de um script, um por linha, no modo em lote.
+ * Ignora linhas vazias e comentários iniciados por '#'.
+ * "nome = comando ..." dá um nome à matriz criada pelo comando; nos argumentos, "$nome" é trocado
+ * pelo índice da matriz com esse nome e "$_" pelo índice da última matriz criada, o que permite
+ * encadear operações sem conhecer os índices.
+ * Exibe o tempo de cada comando. Um erro é exibido com o número da linha e não interrompe o script.
+ * Retorna a quantidade de comandos que falharam.
+ */
+int executarScript(Sessao& sessao, istream& script) {
+    map<string, int> nomes;
+    string linha;
+    int numeroLinha = 0, falhas = 0;
+
+    while(getline(script, linha)) {
+        numeroLinha++;
+        istringstream tokens(linha);
+        vector<string> partes;
+        string token;
+        while(tokens >> token) {
+            partes.push_back(token);
+        }
+        if(partes.empty() || partes[0][0] == '#') continue;
 
-                    cout << "Deseja salvar o resultado? (s/n): ";
-                    char resposta;
-                    cin >> resposta;
+        string nome;
+        if(partes.size() >= 2 && partes[1] == "=") {
+            nome = partes[0];
+            partes.erase(partes.begin(), partes.begin() + 2);
+        }
 
-                    if(resposta == 's' || resposta == 'S') {
-                        matriz_list.push_back(resultado);
-                        cout << "Matriz resultado salva como indice " << matriz_list.size() - 1 << ".\n";
-                    } else {
-                        delete resultado;
+        try {
+            if(partes.empty()) {
+                throw runtime_error("Erro: Comando ausente.");
+            }
+            string argumentos;
+            for(size_t k = 1; k < partes.size(); ++k) {
+                if(partes[k][0] == '$') {
+                    string referencia = partes[k].substr(1);
+                    auto encontrado = nomes.find(referencia);
+                    if(encontrado == nomes.end()) {
+                        throw runtime_error("Erro: Matriz '" + referencia + "' nao definida.");
                     }
-                } catch(const exception& e) {
-                    cerr << "Erro: " << e.what() << endl;
+                    partes[k] = to_string(encontrado->second);
                 }
+                argumentos += partes[k] + " ";
             }
-            // Comando para atualizar um valor na matriz
-            else if (comando == "update") {
-                int index, i, j;
-                double valor;
-                cin >> index >> i >> j >> valor;
-
-                if(index < 0 || index >= static_cast<int>(matriz_list.size())) {
-                    cout << "Indice invalido.\n";
-                    continue;
+
+            size_t antes = sessao.matriz_list.size();
+            istringstream entrada(argumentos);
+            double ms;
+            bool continuar = executarMedindo(sessao, partes[0], entrada, ms);
+
+            ostringstream tempo;
+            tempo << fixed << setprecision(3) << ms;
+            cout << "[" << partes[0] << ": " << tempo.str() << " ms]\n";
+            if(!continuar) break;
+
+            if(sessao.matriz_list.size() < antes) {
+                nomes.clear();
+            } else if(sessao.matriz_list.size() > antes) {
+                nomes["_"] = static_cast<int>(sessao.matriz_list.size()) - 1;
+                if(!nome.empty()) {
+                    nomes[nome] = nomes["_"];
                 }
-                matriz_list[index]->inserir(i, j, valor);
-                cout << "Valor atualizado na matriz.\n";
+            } else if(!nome.empty()) {
+                throw runtime_error("Erro: O comando nao criou uma matriz para receber o nome '" + nome + "'.");
             }
-            // Comando para limpar uma matriz
-            else if(comando == "clear") {
-                int index;
-                cin >> index;
-
-                if(index < 0 || index >= static_cast<int>(matriz_list.size())) {
-                    cout << "Indice invalido.\n";
-                    continue;
-                }
+        } catch(const exception& e) {
+            cerr << "Linha " << numeroLinha << ": " << e.what() << endl;
+            falhas++;
+        }
+    }
+    return falhas;
+}
 
-                matriz_list[index]->clear(); // Suposição de que existe um método clear() na classe SparseMatrix
-                cout << "Matriz " << index << " foi zerada.\n";
+/* Sem argumentos, executa o gerenciador interativo, lendo os comandos do terminal.
+ * Com "--batch [script]", executa os comandos do arquivo script (ou da entrada padrão, se ele for omitido
+ * ou for "-") no modo em lote, sem perguntas nem impressão densa dos resultados, e termina com código 1
+ * se algum comando falhar.
+ */
+int main(int argc, char* argv[]) {
+    Sessao sessao;
+
+    if(argc > 1 && string(argv[1]) == "--batch") {
+        ios::sync_with_stdio(false);
+        sessao.lote = true;
+
+        int falhas;
+        if(argc > 2 && string(argv[2]) != "-") {
+            ifstream script(argv[2]);
+            if(!script.is_open()) {
+                cerr << "Erro ao abrir o arquivo " << argv[2] << "." << endl;
+                return 1;
             }
-            // Comando para contar quantos elementos não nulos tem na matriz
-            else if (comando == "count") {
-                int index;
-                cin >> index;
-
-                if (index < 0 || index >= static_cast<int>(matriz_list.size())) {
-                    throw out_of_range("Erro: Indice invalido.");
-                    continue;
-                }
+            falhas = executarScript(sessao, script);
+        } else {
+            falhas = executarScript(sessao, cin);
+        }
+        return falhas > 0 ? 1 : 0;
+    }
 
-                cout << "A matriz contem " << matriz_list[index]->countNonZero() << " elementos nao nulos.\n";
-            }
-            // Comando para apagar todas as matrizes
-            else if(comando == "eraseAll") {
-                for(auto& matriz : matriz_list) {
-                    delete matriz;
-                }
-                matriz_list.clear();
-                cout << "Todas as matrizes foram apagadas.\n";
-            } 
-            else {
-                cout << "Comando invalido. Digite 'help' para ver a lista de comandos.\n";
-                cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Ignora o restante da linha
-                
+    string comando;
+
+    cout << "Bem-vindo ao gerenciador de Matrizes Esparsas!\n";
+    cout << "Digite 'help' para ver os comandos disponíveis.\n";
+
+    while(true) {
+        cout << "\n>> ";
+        cin >> comando;
+
+        try {
+            double ms;
+            if(!executarMedindo(sessao, comando, cin, ms)) {
+                break;
             }
         } catch(const exception& e) {
             cerr << e.what() << endl;
         }
     }
 
-    for(auto matriz : matriz_list) {
-        delete matriz;
-    }
-
     return 0;
-}
\ No newline at end of file
+}
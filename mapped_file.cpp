@@ -0,0 +1,73 @@
+#include "mapped_file.h"
+#include <fstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MAPPED_FILE_POSIX
+#endif
+
+using namespace std;
+
+/* Abre o arquivo e disponibiliza o seu conteúdo
+ * Em sistemas POSIX, mapeia o arquivo inteiro na memória, somente para leitura; em leitura sequencial,
+ * o sistema antecipa as próximas páginas e pode descartar as já lidas
+ * Nos demais, lê o arquivo inteiro para um buffer
+ * Arquivos vazios não são mapeados; o conteúdo fica vazio
+ * Lança uma exceção se o arquivo não puder ser aberto
+ */
+MappedFile::MappedFile(const string& nomeArquivo, bool sequencial) : m_dados(nullptr), m_tamanho(0), m_mapeado(false) {
+#ifdef MAPPED_FILE_POSIX
+    int fd = open(nomeArquivo.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw runtime_error("Erro ao abrir o arquivo.");
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw runtime_error("Erro ao abrir o arquivo.");
+    }
+    m_tamanho = static_cast<size_t>(info.st_size);
+
+    if (m_tamanho > 0) {
+        void* endereco = mmap(nullptr, m_tamanho, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (endereco == MAP_FAILED) {
+            close(fd);
+            throw runtime_error("Erro ao mapear o arquivo.");
+        }
+        if (sequencial) {
+            madvise(endereco, m_tamanho, MADV_SEQUENTIAL);
+        }
+        m_dados = static_cast<const char*>(endereco);
+        m_mapeado = true;
+    }
+    close(fd);
+#else
+    (void)sequencial;
+    ifstream file(nomeArquivo, ios::binary | ios::ate);
+    if (!file.is_open()) {
+        throw runtime_error("Erro ao abrir o arquivo.");
+    }
+    m_tamanho = static_cast<size_t>(file.tellg());
+    char* buffer = new char[m_tamanho > 0 ? m_tamanho : 1];
+    file.seekg(0);
+    file.read(buffer, static_cast<streamsize>(m_tamanho));
+    m_dados = buffer;
+#endif
+}
+
+/* Desfaz o mapeamento do arquivo ou libera o buffer de leitura
+ */
+MappedFile::~MappedFile() {
+#ifdef MAPPED_FILE_POSIX
+    if (m_mapeado) {
+        munmap(const_cast<char*>(m_dados), m_tamanho);
+        return;
+    }
+#endif
+    delete[] m_dados;
+}
@@ -0,0 +1,34 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+// Definição da classe MappedFile, que dá acesso somente leitura ao conteúdo de um arquivo
+// Em sistemas POSIX o arquivo é mapeado na memória com mmap, sem cópia;
+// nos demais, o conteúdo é lido inteiro para um buffer
+class MappedFile {
+public:
+    // Abre e mapeia o arquivo, lançando uma exceção se não for possível
+    // "sequencial" avisa ao sistema que o conteúdo será lido do início ao fim, uma única vez
+    explicit MappedFile(const std::string& nomeArquivo, bool sequencial = true);
+
+    // Destrutor da classe, desfaz o mapeamento
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Retorna o início do conteúdo do arquivo
+    const char* dados() const { return m_dados; }
+
+    // Retorna o tamanho do arquivo em bytes
+    std::size_t tamanho() const { return m_tamanho; }
+
+private:
+    const char* m_dados;
+    std::size_t m_tamanho;
+    bool m_mapeado; // Verdadeiro se m_dados veio de mmap, falso se é um buffer alocado com new[]
+};
+
+#endif
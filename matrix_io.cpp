@@ -0,0 +1,475 @@
+#include "matrix_io.h"
+#include "mapped_file.h"
+#include "binary_format.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+
+using namespace std;
+
+/* Ordena as triplas pela chave escolhida com uma contagem estável
+ * A chave de cada tripla vai de 1 a maximo; triplas de mesma chave mantêm a ordem relativa
+ * O custo é proporcional à quantidade de triplas mais o valor máximo da chave
+ */
+template <typename Chave>
+static void ordenarPorContagem(const vector<Tripla>& origem, vector<Tripla>& destino, int maximo, Chave chave) {
+    vector<size_t> inicio(maximo + 2, 0);
+    for (const Tripla& t : origem) {
+        inicio[chave(t) + 1]++;
+    }
+    for (int k = 1; k <= maximo + 1; ++k) {
+        inicio[k] += inicio[k - 1];
+    }
+    destino.resize(origem.size());
+    for (const Tripla& t : origem) {
+        destino[inicio[chave(t)]++] = t;
+    }
+}
+
+/* Monta a forma CSR de uma matriz a partir de triplas em qualquer ordem
+ * Verifica os índices e descarta os valores nulos, como faz a inserção elemento a elemento
+ * Ordena as triplas por radix sort: primeiro pela coluna, depois, de forma estável, pela linha
+ * Percorre as triplas ordenadas uma única vez; entre triplas repetidas, mantém a última lida
+ */
+CSRMatrix buildCSR(int linhas, int colunas, vector<Tripla>& triplas) {
+    size_t n = 0;
+    for (const Tripla& t : triplas) {
+        if (t.linha < 1 || t.linha > linhas || t.coluna < 1 || t.coluna > colunas) {
+            throw out_of_range("Erro: Indices fora dos limites da matriz.");
+        }
+        if (t.valor != 0) {
+            triplas[n++] = t;
+        }
+    }
+    triplas.resize(n);
+
+    vector<Tripla> auxiliar;
+    ordenarPorContagem(triplas, auxiliar, colunas, [](const Tripla& t) { return t.coluna; });
+    ordenarPorContagem(auxiliar, triplas, linhas, [](const Tripla& t) { return t.linha; });
+
+    CSRMatrix csr;
+    csr.linhas = linhas;
+    csr.colunas = colunas;
+    csr.row_ptr.assign(linhas + 1, 0);
+    csr.col_idx.reserve(triplas.size());
+    csr.values.reserve(triplas.size());
+
+    for (size_t k = 0; k < triplas.size(); ++k) {
+        const Tripla& t = triplas[k];
+        if (k + 1 < triplas.size() && triplas[k + 1].linha == t.linha && triplas[k + 1].coluna == t.coluna) {
+            continue;
+        }
+        csr.col_idx.push_back(t.coluna);
+        csr.values.push_back(t.valor);
+        csr.row_ptr[t.linha]++;
+    }
+    for (int i = 1; i <= linhas; ++i) {
+        csr.row_ptr[i] += csr.row_ptr[i - 1];
+    }
+    return csr;
+}
+
+/* Avança o cursor sobre espaços, tabulações e quebras de linha
+ */
+static const char* pularEspacos(const char* p, const char* fim) {
+    while (p < fim && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) {
+        ++p;
+    }
+    return p;
+}
+
+/* Lê um número a partir do cursor com std::from_chars, sem passar por iostream
+ * Retorna falso se não houver um número válido na posição
+ */
+template <typename T>
+static bool lerNumero(const char*& p, const char* fim, T& valor) {
+    p = pularEspacos(p, fim);
+    if (p < fim && *p == '+') ++p;
+    auto resultado = from_chars(p, fim, valor);
+    if (resultado.ec != errc()) return false;
+    p = resultado.ptr;
+    return true;
+}
+
+// Identificação na primeira linha dos arquivos Matrix Market
+static const string IDENTIFICACAO_MATRIX_MARKET = "%%MatrixMarket";
+
+/* Retorna verdadeiro se o texto começa com a identificação do formato Matrix Market
+ */
+static bool ehMatrixMarket(const char* p, const char* fim) {
+    return static_cast<size_t>(fim - p) >= IDENTIFICACAO_MATRIX_MARKET.size() &&
+           equal(IDENTIFICACAO_MATRIX_MARKET.begin(), IDENTIFICACAO_MATRIX_MARKET.end(), p);
+}
+
+/* Interpreta o conteúdo de um arquivo Matrix Market de coordenadas
+ * Lê a primeira linha, "%%MatrixMarket matrix coordinate <valores> <simetria>", sem diferenciar maiúsculas,
+ * e recusa os tipos não suportados (array, complex, hermitian)
+ * Pula as linhas de comentário, iniciadas por '%', e lê as dimensões e a quantidade de elementos
+ * Lê exatamente essa quantidade de elementos, recusando de imediato uma quantidade que não caberia no arquivo;
+ * nos arquivos pattern, cada elemento vale 1
+ * Nas matrizes simétricas, guarda os elementos no triângulo inferior, trocando linha e coluna
+ * (e o sinal, na antissimétrica) dos que vierem acima da diagonal
+ * Monta o triângulo (ou a matriz geral) de uma só vez, com buildCSR
+ */
+static MatrizMatrixMarket lerMatrixMarket(const char* p, const char* fim) {
+    const char* fimLinha = find(p, fim, '\n');
+    vector<string> campos;
+    for (const char* q = p; q < fimLinha;) {
+        while (q < fimLinha && isspace(static_cast<unsigned char>(*q))) ++q;
+        string campo;
+        while (q < fimLinha && !isspace(static_cast<unsigned char>(*q))) {
+            campo += static_cast<char>(tolower(static_cast<unsigned char>(*q++)));
+        }
+        if (!campo.empty()) campos.push_back(campo);
+    }
+    if (campos.size() != 5 || campos[0] != "%%matrixmarket" || campos[1] != "matrix") {
+        throw runtime_error("Erro: Cabecalho Matrix Market invalido.");
+    }
+    if (campos[2] != "coordinate") {
+        throw runtime_error("Erro: Apenas o formato Matrix Market coordinate e suportado.");
+    }
+
+    MatrizMatrixMarket resultado;
+    if (campos[3] == "pattern") {
+        resultado.padrao = true;
+    } else if (campos[3] != "real" && campos[3] != "double" && campos[3] != "integer") {
+        throw runtime_error("Erro: Valores Matrix Market nao suportados: " + campos[3] + ".");
+    }
+    if (campos[4] == "symmetric") {
+        resultado.simetria = Simetria::Simetrica;
+    } else if (campos[4] == "skew-symmetric" && !resultado.padrao) {
+        resultado.simetria = Simetria::AntiSimetrica;
+    } else if (campos[4] != "general") {
+        throw runtime_error("Erro: Simetria Matrix Market nao suportada: " + campos[4] + ".");
+    }
+
+    p = fimLinha;
+    while ((p = pularEspacos(p, fim)) < fim && *p == '%') {
+        p = find(p, fim, '\n');
+    }
+
+    int linhas = 0, colunas = 0;
+    long long quantidade = 0;
+    if (!lerNumero(p, fim, linhas) || !lerNumero(p, fim, colunas) || !lerNumero(p, fim, quantidade)) {
+        throw runtime_error("Erro: Dimensoes invalidas no arquivo.");
+    }
+    if (linhas <= 0 || colunas <= 0 || quantidade < 0) {
+        throw invalid_argument("Erro: Dimensoes invalidas! Linhas e colunas devem ser maiores que zero.");
+    }
+    if (resultado.simetria != Simetria::Geral && linhas != colunas) {
+        throw invalid_argument("Erro: Matriz simetrica deve ser quadrada.");
+    }
+    if (quantidade > (fim - p) / 4 + 1) {
+        throw runtime_error("Erro: Arquivo Matrix Market truncado.");
+    }
+
+    vector<Tripla> triplas(static_cast<size_t>(quantidade));
+    for (Tripla& t : triplas) {
+        t.valor = 1.0;
+        if (!lerNumero(p, fim, t.linha) || !lerNumero(p, fim, t.coluna) ||
+            (!resultado.padrao && !lerNumero(p, fim, t.valor))) {
+            throw runtime_error("Erro: Arquivo Matrix Market truncado.");
+        }
+        if (resultado.simetria == Simetria::Geral) continue;
+        if (t.linha < t.coluna) {
+            swap(t.linha, t.coluna);
+            if (resultado.simetria == Simetria::AntiSimetrica) t.valor = -t.valor;
+        } else if (t.linha == t.coluna && resultado.simetria == Simetria::AntiSimetrica && t.valor != 0) {
+            throw invalid_argument("Erro: Matriz antissimetrica com diagonal nao nula.");
+        }
+    }
+
+    resultado.csr = buildCSR(linhas, colunas, triplas);
+    return resultado;
+}
+
+/* Lê um arquivo Matrix Market, mapeando-o na memória, sem expandir a simetria
+ */
+MatrizMatrixMarket readMatrixMarket(const string& nomeArquivo) {
+    MappedFile arquivo(nomeArquivo);
+    const char* p = arquivo.dados();
+    const char* fim = p + arquivo.tamanho();
+    if (!ehMatrixMarket(p, fim)) {
+        throw runtime_error("Erro: Cabecalho Matrix Market invalido.");
+    }
+    return lerMatrixMarket(p, fim);
+}
+
+/* Carrega uma matriz esparsa de um arquivo texto e retorna uma nova matriz
+ * Mapeia o arquivo inteiro na memória e interpreta os números com std::from_chars
+ * Se o arquivo estiver no formato Matrix Market, lê o arquivo e expande a simetria, montando a matriz completa
+ * Lê as dimensões e depois as triplas, até o fim do arquivo ou até o primeiro trecho inválido
+ * Ordena as triplas e monta a matriz linha a linha, em uma única passada
+ * Lança uma exceção se o arquivo não puder ser aberto ou se as dimensões forem inválidas
+ */
+SparseMatrix* loadSparseMatrix(const string& nomeArquivo) {
+    MappedFile arquivo(nomeArquivo);
+    const char* p = arquivo.dados();
+    const char* fim = p + arquivo.tamanho();
+
+    if (ehMatrixMarket(p, fim)) {
+        MatrizMatrixMarket lida = lerMatrixMarket(p, fim);
+        if (lida.simetria == Simetria::Geral) {
+            return new SparseMatrix(lida.csr);
+        }
+        return new SparseMatrix(expandirSimetria(lida.csr, lida.simetria));
+    }
+
+    int linhas = 0, colunas = 0;
+    if (!lerNumero(p, fim, linhas) || !lerNumero(p, fim, colunas)) {
+        throw runtime_error("Erro: Dimensoes invalidas no arquivo.");
+    }
+    if (linhas <= 0 || colunas <= 0) {
+        throw invalid_argument("Erro: Dimensoes invalidas! Linhas e colunas devem ser maiores que zero.");
+    }
+
+    vector<Tripla> triplas;
+    triplas.reserve(arquivo.tamanho() / 16);
+    Tripla t;
+    while (lerNumero(p, fim, t.linha) && lerNumero(p, fim, t.coluna) && lerNumero(p, fim, t.valor)) {
+        triplas.push_back(t);
+    }
+
+    return new SparseMatrix(buildCSR(linhas, colunas, triplas));
+}
+
+// Escreve texto em um buffer fixo e o descarrega na saída em blocos, sem formatação de iostream
+class FormatadorSaida {
+public:
+    explicit FormatadorSaida(ostream& saida) : m_saida(saida), m_pos(0) {}
+    ~FormatadorSaida() { descarregar(); }
+
+    FormatadorSaida(const FormatadorSaida&) = delete;
+    FormatadorSaida& operator=(const FormatadorSaida&) = delete;
+
+    // Escreve um número inteiro ou real; os reais usam a menor representação que os relê sem perda
+    template <typename T>
+    void numero(T valor) {
+        reservar(32);
+        m_pos = static_cast<size_t>(to_chars(m_buffer + m_pos, m_buffer + TAMANHO, valor).ptr - m_buffer);
+    }
+
+    void caractere(char c) {
+        reservar(1);
+        m_buffer[m_pos++] = c;
+    }
+
+    void texto(const string& s) {
+        for (char c : s) caractere(c);
+    }
+
+    void descarregar() {
+        m_saida.write(m_buffer, static_cast<streamsize>(m_pos));
+        m_pos = 0;
+    }
+
+private:
+    static const size_t TAMANHO = 1 << 16;
+    ostream& m_saida;
+    size_t m_pos;
+    char m_buffer[TAMANHO];
+
+    void reservar(size_t n) {
+        if (m_pos + n > TAMANHO) descarregar();
+    }
+};
+
+/* Escreve os elementos não nulos da matriz, sem percorrer as posições vazias
+ * Escreve o cabeçalho do formato: "m n" nas triplas; a identificação do Matrix Market seguida de "m n nnz"
+ * Percorre as linhas de cima para baixo, lendo a forma CSR quando a matriz está congelada
+ * e as listas das linhas nos demais casos, e escreve uma linha "i j valor" por elemento
+ * Monta a saída em um buffer de 64 KB, descarregado na saída a cada vez que enche
+ */
+void writeSparseMatrix(const SparseMatrix* A, ostream& saida, FormatoTexto formato) {
+    FormatadorSaida f(saida);
+    if (formato == FormatoTexto::MatrixMarket) {
+        f.texto(IDENTIFICACAO_MATRIX_MARKET + " matrix coordinate real general\n");
+    }
+    f.numero(A->getLinhas());
+    f.caractere(' ');
+    f.numero(A->getColunas());
+    if (formato == FormatoTexto::MatrixMarket) {
+        f.caractere(' ');
+        f.numero(A->countNonZero());
+    }
+    f.caractere('\n');
+
+    auto escrever = [&f](int i, int j, double valor) {
+        f.numero(i);
+        f.caractere(' ');
+        f.numero(j);
+        f.caractere(' ');
+        f.numero(valor);
+        f.caractere('\n');
+    };
+
+    if (A->isFrozen()) {
+        const CSRView& csr = *A->getCSR();
+        for (int i = 1; i <= csr.linhas; ++i) {
+            for (int k = csr.row_ptr[i - 1]; k < csr.row_ptr[i]; ++k) {
+                escrever(i, csr.col_idx[k], csr.values[k]);
+            }
+        }
+    } else {
+        for (int i = 1; i <= A->getLinhas(); ++i) {
+            Node* linha = A->getLinha(i);
+            for (Node* elemento = linha->direita; elemento != linha; elemento = elemento->direita) {
+                escrever(i, elemento->coluna, elemento->valor);
+            }
+        }
+    }
+}
+
+/* Grava a matriz em um arquivo texto no formato escolhido
+ * Lança uma exceção se o arquivo não puder ser aberto ou escrito
+ */
+void saveSparseMatrix(const SparseMatrix* A, const string& nomeArquivo, FormatoTexto formato) {
+    ofstream file(nomeArquivo, ios::trunc);
+    if (!file.is_open()) {
+        throw runtime_error("Erro ao abrir o arquivo.");
+    }
+    writeSparseMatrix(A, file, formato);
+    file.flush();
+    if (!file) {
+        throw runtime_error("Erro ao gravar o arquivo.");
+    }
+}
+
+/* Grava a matriz no formato Matrix Market de coordenadas
+ * Usa a forma CSR da matriz congelada; as demais são copiadas para a forma CSR antes
+ * Compara a matriz com a sua transposta para escolher a simetria; as simétricas e antissimétricas
+ * têm apenas o triângulo inferior gravado, ocupando cerca de metade do espaço
+ * Sem valores (pattern), uma matriz antissimétrica é gravada como geral, pois o formato não a prevê
+ * Conta os elementos gravados antes de escrever o cabeçalho, e monta a saída com FormatadorSaida
+ * Lança uma exceção se o arquivo não puder ser aberto ou escrito
+ */
+void saveMatrixMarket(const SparseMatrix* A, const string& nomeArquivo, bool padrao) {
+    CSRMatrix copia;
+    CSRView csr = A->isFrozen() ? *A->getCSR() : CSRView(copia = A->toCSR());
+
+    Simetria simetria = detectarSimetria(csr);
+    if (padrao && simetria == Simetria::AntiSimetrica) {
+        simetria = Simetria::Geral;
+    }
+    bool triangulo = simetria != Simetria::Geral;
+
+    long long quantidade = 0;
+    for (int i = 1; i <= csr.linhas; ++i) {
+        for (int k = csr.row_ptr[i - 1]; k < csr.row_ptr[i]; ++k) {
+            if (!triangulo || csr.col_idx[k] <= i) ++quantidade;
+        }
+    }
+
+    ofstream file(nomeArquivo, ios::trunc);
+    if (!file.is_open()) {
+        throw runtime_error("Erro ao abrir o arquivo.");
+    }
+    {
+        FormatadorSaida f(file);
+        f.texto(IDENTIFICACAO_MATRIX_MARKET);
+        f.texto(padrao ? " matrix coordinate pattern " : " matrix coordinate real ");
+        f.texto(simetria == Simetria::Simetrica ? "symmetric\n" : simetria == Simetria::AntiSimetrica ? "skew-symmetric\n" : "general\n");
+        f.numero(csr.linhas);
+        f.caractere(' ');
+        f.numero(csr.colunas);
+        f.caractere(' ');
+        f.numero(quantidade);
+        f.caractere('\n');
+
+        for (int i = 1; i <= csr.linhas; ++i) {
+            for (int k = csr.row_ptr[i - 1]; k < csr.row_ptr[i]; ++k) {
+                if (triangulo && csr.col_idx[k] > i) continue;
+                f.numero(i);
+                f.caractere(' ');
+                f.numero(csr.col_idx[k]);
+                if (!padrao) {
+                    f.caractere(' ');
+                    f.numero(csr.values[k]);
+                }
+                f.caractere('\n');
+            }
+        }
+    }
+    file.flush();
+    if (!file) {
+        throw runtime_error("Erro ao gravar o arquivo.");
+    }
+}
+
+/* Grava a matriz no formato binário
+ * Usa a forma CSR da matriz congelada; as demais são copiadas para a forma CSR antes
+ * Calcula a soma de verificação e grava o cabeçalho seguido dos vetores, cada um de uma só vez
+ * Lança uma exceção se o arquivo não puder ser aberto ou escrito
+ */
+void saveBinary(const SparseMatrix* A, const string& nomeArquivo) {
+    CSRMatrix copia;
+    CSRView csr = A->isFrozen() ? *A->getCSR() : CSRView(copia = A->toCSR());
+
+    CabecalhoBinario cabecalho = CabecalhoBinario::criar(csr.linhas, csr.colunas, csr.nnz());
+    cabecalho.checksum = calcularChecksum(cabecalho, csr);
+
+    LayoutBinario layout(csr.linhas, csr.nnz());
+    const char zeros[8] = {};
+
+    ofstream file(nomeArquivo, ios::binary | ios::trunc);
+    if (!file.is_open()) {
+        throw runtime_error("Erro ao abrir o arquivo.");
+    }
+    file.write(reinterpret_cast<const char*>(&cabecalho), sizeof(cabecalho));
+    file.write(reinterpret_cast<const char*>(csr.row_ptr), static_cast<streamsize>(layout.colIdx - layout.rowPtr));
+    file.write(reinterpret_cast<const char*>(csr.col_idx), static_cast<streamsize>(csr.nnz() * sizeof(int32_t)));
+    file.write(zeros, static_cast<streamsize>(layout.values - layout.colIdx - csr.nnz() * sizeof(int32_t)));
+    file.write(reinterpret_cast<const char*>(csr.values), static_cast<streamsize>(layout.tamanho - layout.values));
+    if (!file) {
+        throw runtime_error("Erro ao gravar o arquivo.");
+    }
+}
+
+/* Confere a estrutura de uma matriz CSR lida de um arquivo
+ * row_ptr precisa ser crescente e as colunas de cada linha estritamente crescentes e dentro dos limites
+ */
+static bool estruturaValida(const CSRView& csr) {
+    for (int i = 1; i <= csr.linhas; ++i) {
+        if (csr.row_ptr[i] < csr.row_ptr[i - 1]) return false;
+        int anterior = 0;
+        for (int k = csr.row_ptr[i - 1]; k < csr.row_ptr[i]; ++k) {
+            if (csr.col_idx[k] <= anterior || csr.col_idx[k] > csr.colunas) return false;
+            anterior = csr.col_idx[k];
+        }
+    }
+    return true;
+}
+
+/* Abre uma matriz gravada no formato binário, sem copiar nem converter os seus elementos
+ * Mapeia o arquivo na memória e confere o cabeçalho: identificação, versão, ordem de bytes e dimensões
+ * Confere se o tamanho do arquivo corresponde exatamente às dimensões, detectando arquivos truncados,
+ * e se row_ptr começa em zero e termina em nnz
+ * Com "verificar", recalcula a soma de verificação e confere a estrutura de todas as linhas
+ * A matriz é construída congelada sobre os vetores do próprio arquivo, que continua mapeado enquanto ela existir;
+ * sem a verificação, o custo não depende do tamanho da matriz, e as páginas só são lidas do disco quando usadas
+ * Lança uma exceção se o arquivo não puder ser aberto ou estiver inválido
+ */
+SparseMatrix* openBinary(const string& nomeArquivo, bool verificar) {
+    shared_ptr<MappedFile> arquivo = make_shared<MappedFile>(nomeArquivo, false);
+
+    CabecalhoBinario cabecalho = CabecalhoBinario::ler(arquivo->dados(), arquivo->tamanho());
+    LayoutBinario layout(cabecalho.linhas, cabecalho.nnz);
+
+    CSRView csr;
+    csr.linhas = static_cast<int>(cabecalho.linhas);
+    csr.colunas = static_cast<int>(cabecalho.colunas);
+    csr.row_ptr = reinterpret_cast<const int*>(arquivo->dados() + layout.rowPtr);
+    csr.col_idx = reinterpret_cast<const int*>(arquivo->dados() + layout.colIdx);
+    csr.values = reinterpret_cast<const double*>(arquivo->dados() + layout.values);
+    if (csr.row_ptr[0] != 0 || csr.row_ptr[csr.linhas] != cabecalho.nnz) {
+        throw runtime_error("Erro: Arquivo binario corrompido.");
+    }
+    if (verificar && (calcularChecksum(cabecalho, csr) != cabecalho.checksum || !estruturaValida(csr))) {
+        throw runtime_error("Erro: Arquivo binario corrompido.");
+    }
+
+    return new SparseMatrix(csr, CSRView(), arquivo);
+}
@@ -0,0 +1,61 @@
+#ifndef MATRIX_IO_H
+#define MATRIX_IO_H
+
+#include "sparse_matrix.h"
+#include "csr_matrix.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Elemento lido de um arquivo: posição (linha, coluna) e valor
+struct Tripla {
+    int linha, coluna;
+    double valor;
+};
+
+// Monta a forma CSR de uma matriz a partir de triplas em qualquer ordem
+// Ordena as triplas por (linha, coluna) em tempo linear; entre repetidas, vale a última
+// Descarta valores nulos e lança uma exceção se algum índice estiver fora dos limites
+CSRMatrix buildCSR(int linhas, int colunas, std::vector<Tripla>& triplas);
+
+// Carrega uma matriz do arquivo texto no formato "m n" seguido de triplas "i j valor"
+// Arquivos iniciados por "%%MatrixMarket" são lidos por readMatrixMarket e têm a simetria expandida
+SparseMatrix* loadSparseMatrix(const std::string& nomeArquivo);
+
+// Formatos texto de gravação: triplas "i j valor" (o mesmo lido por loadSparseMatrix) ou Matrix Market de coordenadas
+enum class FormatoTexto { Triplas, MatrixMarket };
+
+// Escreve apenas os elementos não nulos da matriz, linha a linha, no formato escolhido
+// A saída é montada em um buffer com std::to_chars, com os valores na menor forma que os relê sem perda
+void writeSparseMatrix(const SparseMatrix* A, std::ostream& saida, FormatoTexto formato);
+
+// Grava a matriz em um arquivo texto no formato escolhido, lançando uma exceção se o arquivo não puder ser escrito
+void saveSparseMatrix(const SparseMatrix* A, const std::string& nomeArquivo, FormatoTexto formato);
+
+// Matriz lida de um arquivo Matrix Market, sem expandir a simetria
+// Nas matrizes simétricas e antissimétricas, csr guarda apenas o triângulo inferior, como o arquivo;
+// a matriz completa só é montada por expandirSimetria, quando for necessária
+struct MatrizMatrixMarket {
+    CSRMatrix csr;
+    Simetria simetria = Simetria::Geral;
+    bool padrao = false;  // Arquivo "pattern", sem valores: todos os elementos valem 1
+};
+
+// Lê um arquivo Matrix Market de coordenadas, com valores real, integer ou pattern e simetria
+// general, symmetric ou skew-symmetric; lança uma exceção se o arquivo for inválido ou de outro tipo
+MatrizMatrixMarket readMatrixMarket(const std::string& nomeArquivo);
+
+// Grava a matriz no formato Matrix Market de coordenadas; se ela for simétrica ou antissimétrica,
+// grava apenas o triângulo inferior. Com "padrao", grava só as posições dos elementos (pattern)
+void saveMatrixMarket(const SparseMatrix* A, const std::string& nomeArquivo, bool padrao = false);
+
+// Grava a matriz no formato binário: cabeçalho seguido dos vetores row_ptr, col_idx e values da forma CSR
+// Lança uma exceção se o arquivo não puder ser escrito
+void saveBinary(const SparseMatrix* A, const std::string& nomeArquivo);
+
+// Abre uma matriz gravada por saveBinary, já congelada e lendo os vetores direto do arquivo mapeado na memória
+// O tamanho do arquivo é sempre conferido, o que detecta arquivos truncados em tempo constante;
+// com "verificar", confere também a soma de verificação e a estrutura, lendo o arquivo inteiro
+SparseMatrix* openBinary(const std::string& nomeArquivo, bool verificar = true);
+
+#endif
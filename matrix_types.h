@@ -0,0 +1,20 @@
+#ifndef MATRIX_TYPES_H
+#define MATRIX_TYPES_H
+
+#include <complex>
+#include <cstdint>
+
+// Combinações de tipo de valor e tipo de índice para as quais as classes e as operações da matriz
+// são instanciadas explicitamente. Cada arquivo .cpp define uma macro INSTANCIAR(T, Index) com as
+// suas instanciações e a aplica a todas as combinações com PARA_CADA_TIPO_MATRIZ(INSTANCIAR)
+#define PARA_CADA_TIPO_MATRIZ(X) \
+    X(double, int32_t)           \
+    X(double, int64_t)           \
+    X(float, int32_t)            \
+    X(float, int64_t)            \
+    X(int, int32_t)              \
+    X(int, int64_t)              \
+    X(std::complex<double>, int32_t) \
+    X(std::complex<double>, int64_t)
+
+#endif
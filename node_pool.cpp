@@ -0,0 +1,84 @@
+#include "node_pool.h"
+#include "matrix_types.h"
+#include <new>
+#include <utility>
+
+using namespace std;
+
+/* Destrói o pool devolvendo todos os blocos ao sistema
+ * Os nós não possuem destrutor próprio, então basta liberar a memória dos blocos
+ */
+template <typename T, typename Index>
+NodePoolT<T, Index>::~NodePoolT() {
+    for (Node* bloco : blocos) {
+        ::operator delete(bloco);
+    }
+}
+
+/* Retorna um nó inicializado com os valores informados
+ * Reaproveita primeiro um nó da lista livre, se houver
+ * Caso contrário, entrega o próximo nó do bloco atual
+ * Reserva um novo bloco quando o atual estiver esgotado
+ */
+template <typename T, typename Index>
+NodeT<T, Index>* NodePoolT<T, Index>::alocar(Index i, Index j, T valor) {
+    Node* memoria;
+    if (livres) {
+        memoria = livres;
+        livres = livres->direita;
+        contadores.reutilizados++;
+    } else {
+        if (usadosNoBloco == TAMANHO_BLOCO) {
+            blocos.push_back(static_cast<Node*>(::operator new(TAMANHO_BLOCO * sizeof(Node))));
+            usadosNoBloco = 0;
+            contadores.blocos++;
+        }
+        memoria = blocos.back() + usadosNoBloco++;
+    }
+
+    contadores.alocados++;
+    emUsoAtual++;
+    return new (memoria) Node(i, j, valor);
+}
+
+/* Devolve um nó ao pool
+ * O nó é encadeado no início da lista livre e será o próximo a ser reaproveitado
+ */
+template <typename T, typename Index>
+void NodePoolT<T, Index>::liberar(Node* no) {
+    no->direita = livres;
+    livres = no;
+    contadores.liberados++;
+    emUsoAtual--;
+}
+
+/* Libera todos os nós do pool de uma só vez
+ * Devolve os blocos ao sistema sem percorrer os nós individualmente
+ * Descarta a lista livre, que aponta para dentro dos blocos liberados
+ */
+template <typename T, typename Index>
+void NodePoolT<T, Index>::liberarTudo() {
+    for (Node* bloco : blocos) {
+        ::operator delete(bloco);
+    }
+    blocos.clear();
+    usadosNoBloco = TAMANHO_BLOCO;
+    livres = nullptr;
+    contadores.liberados += emUsoAtual;
+    emUsoAtual = 0;
+}
+
+/* Troca os blocos, a lista livre e os contadores com outro pool
+ * Os nós continuam nos mesmos blocos, por isso os ponteiros para eles permanecem válidos
+ */
+template <typename T, typename Index>
+void NodePoolT<T, Index>::trocar(NodePoolT& outro) noexcept {
+    blocos.swap(outro.blocos);
+    swap(usadosNoBloco, outro.usadosNoBloco);
+    swap(livres, outro.livres);
+    swap(emUsoAtual, outro.emUsoAtual);
+    swap(contadores, outro.contadores);
+}
+
+#define INSTANCIAR(T, Index) template class NodePoolT<T, Index>;
+PARA_CADA_TIPO_MATRIZ(INSTANCIAR)
@@ -0,0 +1,69 @@
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#include "Node.h"
+#include <cstddef>
+#include <vector>
+
+// Contadores de alocação acumulados ao longo da vida de um pool de nós
+struct ContadoresAlocacao {
+    std::size_t alocados = 0;     // Nós entregues por alocar()
+    std::size_t liberados = 0;    // Nós devolvidos por liberar() ou liberarTudo()
+    std::size_t reutilizados = 0; // Alocações atendidas pela lista livre
+    std::size_t blocos = 0;       // Blocos reservados do sistema
+};
+
+// Definição da classe NodePoolT, que fornece os nós de uma matriz esparsa com valores T e índices Index
+// Reserva os nós em blocos contíguos e reaproveita os nós liberados por meio de uma lista livre
+template <typename T, typename Index>
+class NodePoolT {
+public:
+    using Node = NodeT<T, Index>;
+    using Contadores = ContadoresAlocacao;
+
+    // Quantidade de nós reservados em cada bloco
+    static const std::size_t TAMANHO_BLOCO = 1024;
+
+    NodePoolT() = default;
+
+    // Destrutor da classe, devolve todos os blocos ao sistema
+    ~NodePoolT();
+
+    NodePoolT(const NodePoolT&) = delete;
+    NodePoolT& operator=(const NodePoolT&) = delete;
+
+    // Retorna um nó inicializado com (i, j, valor)
+    Node* alocar(Index i, Index j, T valor);
+
+    // Devolve um nó à lista livre para ser reaproveitado
+    void liberar(Node* no);
+
+    // Libera de uma só vez todos os nós do pool, devolvendo os blocos ao sistema
+    void liberarTudo();
+
+    // Troca o conteúdo deste pool pelo de outro, em tempo constante; os nós não mudam de endereço
+    void trocar(NodePoolT& outro) noexcept;
+
+    // Retorna os contadores de alocação
+    const Contadores& getContadores() const { return contadores; }
+
+    // Retorna a quantidade de nós em uso
+    std::size_t emUso() const { return emUsoAtual; }
+
+    // Retorna a quantidade de bytes reservados do sistema pelos blocos, incluindo os nós livres
+    std::size_t bytes() const {
+        return blocos.size() * TAMANHO_BLOCO * sizeof(Node) + blocos.capacity() * sizeof(Node*);
+    }
+
+private:
+    std::vector<Node*> blocos; // Blocos de TAMANHO_BLOCO nós
+    std::size_t usadosNoBloco = TAMANHO_BLOCO; // Nós já entregues do último bloco
+    Node* livres = nullptr; // Lista livre, encadeada pelo ponteiro "direita"
+    std::size_t emUsoAtual = 0;
+    Contadores contadores;
+};
+
+// Pool dos nós da matriz usada pelo programa
+using NodePool = NodePoolT<double, int>;
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef PROFILING_H
+#define PROFILING_H
+
+#include <atomic>
+
+// Instrumentação dos caminhos críticos das matrizes esparsas, ligada ao compilar com -DSPARSE_PROFILING
+// Desligada (o padrão), PERFIL(...) não gera nenhuma instrução e as matrizes não guardam os contadores,
+// de modo que o código compilado é o mesmo de antes da instrumentação. Todos os arquivos do programa
+// devem ser compilados com a mesma opção.
+#ifdef SPARSE_PROFILING
+#define PERFIL(instrucao) instrucao
+constexpr bool PERFIL_ATIVO = true;
+#else
+#define PERFIL(instrucao)
+constexpr bool PERFIL_ATIVO = false;
+#endif
+
+// Contadores de percurso de uma matriz, lidos por SparseMatrixT::getContadoresPercurso
+// Ficam em zero se a instrumentação estiver desligada
+struct ContadoresPercurso {
+    long long saltos = 0;     // Ponteiros seguidos ao percorrer as listas das linhas e das colunas
+    long long consultas = 0;  // Chamadas a get, inclusive as feitas por outras operações
+    long long insercoes = 0;  // Chamadas a inserir com valor não nulo
+    long long remocoes = 0;   // Chamadas a remover (e a inserir com valor nulo)
+    long long religacoes = 0; // Vezes em que as listas das colunas foram religadas
+};
+
+// Contadores de percurso mantidos por uma matriz com a instrumentação ligada
+// São atômicos porque uma mesma matriz pode ser lida por várias threads ao mesmo tempo (get, sum e
+// multiply em paralelo); os percursos somam os saltos em uma variável local e os registram de uma só vez
+struct PerfilMatriz {
+    std::atomic<long long> saltos{0};
+    std::atomic<long long> consultas{0};
+    std::atomic<long long> insercoes{0};
+    std::atomic<long long> remocoes{0};
+    std::atomic<long long> religacoes{0};
+
+    // Soma n a um contador, sem ordenar a operação em relação às demais
+    static void somar(std::atomic<long long>& contador, long long n) {
+        contador.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    // Retorna os valores atuais dos contadores
+    ContadoresPercurso ler() const {
+        ContadoresPercurso c;
+        c.saltos = saltos.load(std::memory_order_relaxed);
+        c.consultas = consultas.load(std::memory_order_relaxed);
+        c.insercoes = insercoes.load(std::memory_order_relaxed);
+        c.remocoes = remocoes.load(std::memory_order_relaxed);
+        c.religacoes = religacoes.load(std::memory_order_relaxed);
+        return c;
+    }
+
+    // Troca os contadores com os de outra matriz, quando as duas trocam de conteúdo
+    void trocar(PerfilMatriz& outro) {
+        ContadoresPercurso meus = ler(), dele = outro.ler();
+        guardar(dele);
+        outro.guardar(meus);
+    }
+
+private:
+    void guardar(const ContadoresPercurso& c) {
+        saltos.store(c.saltos, std::memory_order_relaxed);
+        consultas.store(c.consultas, std::memory_order_relaxed);
+        insercoes.store(c.insercoes, std::memory_order_relaxed);
+        remocoes.store(c.remocoes, std::memory_order_relaxed);
+        religacoes.store(c.religacoes, std::memory_order_relaxed);
+    }
+};
+
+#endif
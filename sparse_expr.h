@@ -0,0 +1,383 @@
+#ifndef SPARSE_EXPR_H
+#define SPARSE_EXPR_H
+
+#include "sparse_matrix.h"
+#include "csr_matrix.h"
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Expressões preguiçosas sobre matrizes esparsas
+// expressao(A) embrulha uma matriz sem copiá-la; +, -, * e a multiplicação por escalar sobre expressões apenas
+// montam a árvore da expressão, e nada é calculado até avaliar(e) ou C += e. A avaliação percorre as linhas
+// uma única vez: cada nó soma a sua contribuição para a linha i em um acumulador denso compartilhado,
+// de modo que somas encadeadas (A + B + C, alpha * A + beta * B) e produtos somados (A * B + C) não criam
+// nenhuma matriz intermediária. Os operandos precisam continuar existindo até a expressão ser avaliada.
+//
+//     SparseMatrix D = avaliar(2.0 * expressao(A) * expressao(B) + expressao(C));
+//     C += expressao(A) * expressao(B);   // acumula A * B diretamente nas linhas de C
+
+// Acumulador de uma linha: soma contribuições em qualquer ordem de coluna e entrega a linha ordenada
+// Linhas curtas ficam em uma lista de pares (coluna, valor), ordenada só no fim; acima de LIMITE_PARES
+// contribuições, os pares passam para um vetor denso, com um marcador por coluna que indica quais posições
+// já pertencem à linha atual, sem precisar zerar o vetor a cada linha
+template <typename T, typename Index>
+class AcumuladorLinha {
+private:
+    std::vector<std::pair<Index, T>> pares;
+    std::vector<T> valores;
+    std::vector<Index> marcador;
+    std::vector<Index> usadas;
+    Index marca;
+    bool denso;
+
+    void somarDenso(Index j, T v) {
+        if (marcador[j] != marca) {
+            marcador[j] = marca;
+            usadas.push_back(j);
+            valores[j] = v;
+        } else {
+            valores[j] += v;
+        }
+    }
+
+public:
+    // Quantidade de contribuições de uma linha a partir da qual o acumulador passa a ser denso
+    static constexpr std::size_t LIMITE_PARES = 64;
+
+    // Cria um acumulador para linhas de até "colunas" colunas
+    explicit AcumuladorLinha(Index colunas) : valores(colunas + 1), marcador(colunas + 1, 0), marca(1), denso(false) {}
+
+    // Soma v à coluna j da linha atual
+    void somar(Index j, T v) {
+        if (denso) {
+            somarDenso(j, v);
+            return;
+        }
+        pares.emplace_back(j, v);
+        if (pares.size() > LIMITE_PARES) {
+            denso = true;
+            for (const auto& par : pares) {
+                somarDenso(par.first, par.second);
+            }
+            pares.clear();
+        }
+    }
+
+    // Entrega a linha atual em ordem crescente de coluna, sem as somas nulas, e começa uma nova linha
+    void extrair(std::vector<Index>& cols, std::vector<T>& vals) {
+        cols.clear();
+        vals.clear();
+        if (!denso) {
+            std::sort(pares.begin(), pares.end(),
+                      [](const std::pair<Index, T>& a, const std::pair<Index, T>& b) { return a.first < b.first; });
+            for (std::size_t k = 0; k < pares.size();) {
+                Index j = pares[k].first;
+                T soma = pares[k].second;
+                for (++k; k < pares.size() && pares[k].first == j; ++k) {
+                    soma += pares[k].second;
+                }
+                if (soma != T()) {
+                    cols.push_back(j);
+                    vals.push_back(soma);
+                }
+            }
+            pares.clear();
+            return;
+        }
+
+        std::sort(usadas.begin(), usadas.end());
+        for (Index j : usadas) {
+            if (valores[j] != T()) {
+                cols.push_back(j);
+                vals.push_back(valores[j]);
+            }
+        }
+        usadas.clear();
+        ++marca;
+        denso = false;
+    }
+};
+
+// Base de todos os nós de expressão; permite que os operadores aceitem apenas expressões
+// Cada nó E define Valor, Indice, linhas(), colunas(), usa(m) e acumularLinha(i, coef, acumulador),
+// que soma coef vezes a linha i da expressão no acumulador
+template <typename E>
+struct Expressao {
+    const E& derivada() const { return static_cast<const E&>(*this); }
+};
+
+// Folha da expressão: uma matriz existente, lida linha a linha, congelada ou não
+template <typename T, typename Index>
+class ExprMatriz : public Expressao<ExprMatriz<T, Index>> {
+private:
+    const SparseMatrixT<T, Index>* m;
+
+public:
+    using Valor = T;
+    using Indice = Index;
+
+    explicit ExprMatriz(const SparseMatrixT<T, Index>& matriz) : m(&matriz) {}
+
+    Index linhas() const { return m->getLinhas(); }
+    Index colunas() const { return m->getColunas(); }
+    bool usa(const void* matriz) const { return m == matriz; }
+
+    // Chama f(j, valor) para cada elemento da linha i, em ordem crescente de coluna
+    template <typename F>
+    void paraCadaElemento(Index i, F f) const {
+        if (m->isFrozen()) {
+            const CSRViewT<T, Index>& csr = *m->getCSR();
+            for (Index k = csr.row_ptr[i - 1]; k < csr.row_ptr[i]; ++k) {
+                f(csr.col_idx[k], csr.values[k]);
+            }
+        } else {
+            const NodeT<T, Index>* linha = m->getLinha(i);
+            PERFIL(long long saltos = 1;)
+            for (const NodeT<T, Index>* elemento = linha->direita; elemento != linha; elemento = elemento->direita) {
+                f(elemento->coluna, elemento->valor);
+                PERFIL(++saltos;)
+            }
+            PERFIL(m->contarSaltos(saltos);)
+        }
+    }
+
+    void acumularLinha(Index i, T coef, AcumuladorLinha<T, Index>& acumulador) const {
+        paraCadaElemento(i, [&](Index j, T v) { acumulador.somar(j, coef * v); });
+    }
+};
+
+// Transposta de uma matriz existente: a linha i é a coluna i da matriz
+// Descongelada, percorre a lista da coluna; congelada, usa a forma CSC, se existir, ou transpõe a forma CSR
+// uma única vez, na primeira linha pedida (a única cópia que a avaliação pode fazer)
+template <typename T, typename Index>
+class ExprTransposta : public Expressao<ExprTransposta<T, Index>> {
+private:
+    const SparseMatrixT<T, Index>* m;
+    mutable std::shared_ptr<CSRMatrixT<T, Index>> transposta;
+
+public:
+    using Valor = T;
+    using Indice = Index;
+
+    explicit ExprTransposta(const SparseMatrixT<T, Index>& matriz) : m(&matriz) {}
+
+    Index linhas() const { return m->getColunas(); }
+    Index colunas() const { return m->getLinhas(); }
+    bool usa(const void* matriz) const { return m == matriz; }
+
+    void acumularLinha(Index i, T coef, AcumuladorLinha<T, Index>& acumulador) const {
+        if (!m->isFrozen()) {
+            PERFIL(long long saltos = 1;)
+            for (const NodeT<T, Index>& elemento : m->coluna(i)) {
+                acumulador.somar(elemento.linha, coef * elemento.valor);
+                PERFIL(++saltos;)
+            }
+            PERFIL(m->contarSaltos(saltos);)
+            return;
+        }
+        if (!m->getCSC() && !transposta) {
+            transposta = std::make_shared<CSRMatrixT<T, Index>>(transpor(*m->getCSR()));
+        }
+        CSRViewT<T, Index> csc = m->getCSC() ? *m->getCSC() : CSRViewT<T, Index>(*transposta);
+        for (Index k = csc.row_ptr[i - 1]; k < csc.row_ptr[i]; ++k) {
+            acumulador.somar(csc.col_idx[k], coef * csc.values[k]);
+        }
+    }
+};
+
+// Expressão multiplicada por um escalar: alpha * E
+template <typename E>
+class ExprEscala : public Expressao<ExprEscala<E>> {
+public:
+    using Valor = typename E::Valor;
+    using Indice = typename E::Indice;
+
+private:
+    E operando;
+    Valor alpha;
+
+public:
+    ExprEscala(const E& e, Valor a) : operando(e), alpha(a) {}
+
+    Indice linhas() const { return operando.linhas(); }
+    Indice colunas() const { return operando.colunas(); }
+    bool usa(const void* matriz) const { return operando.usa(matriz); }
+
+    void acumularLinha(Indice i, Valor coef, AcumuladorLinha<Valor, Indice>& acumulador) const {
+        operando.acumularLinha(i, coef * alpha, acumulador);
+    }
+};
+
+// Soma de duas expressões de mesmas dimensões: as duas somam a linha i no mesmo acumulador
+template <typename E1, typename E2>
+class ExprSoma : public Expressao<ExprSoma<E1, E2>> {
+public:
+    using Valor = typename E1::Valor;
+    using Indice = typename E1::Indice;
+
+private:
+    E1 esquerda;
+    E2 direita;
+
+public:
+    ExprSoma(const E1& a, const E2& b) : esquerda(a), direita(b) {
+        if (a.linhas() != b.linhas() || a.colunas() != b.colunas()) {
+            throw std::runtime_error("As matrizes tem dimensoes incompativeis para soma.");
+        }
+    }
+
+    Indice linhas() const { return esquerda.linhas(); }
+    Indice colunas() const { return esquerda.colunas(); }
+    bool usa(const void* matriz) const { return esquerda.usa(matriz) || direita.usa(matriz); }
+
+    void acumularLinha(Indice i, Valor coef, AcumuladorLinha<Valor, Indice>& acumulador) const {
+        esquerda.acumularLinha(i, coef, acumulador);
+        direita.acumularLinha(i, coef, acumulador);
+    }
+};
+
+// Produto de duas expressões, pelo algoritmo de Gustavson: a linha i de E1 * E2 soma as linhas k de E2
+// multiplicadas pelos elementos (i, k) de E1. A linha de E1 é lida diretamente se E1 for uma matriz,
+// ou calculada em um acumulador próprio do nó; as linhas de E2 são somadas direto no acumulador do resultado.
+// Produtos encadeados são mais baratos associados à esquerda, (A * B) * C, como os operadores já fazem:
+// à direita, cada linha de B * C seria recalculada a cada uso
+template <typename E1, typename E2>
+class ExprProduto : public Expressao<ExprProduto<E1, E2>> {
+public:
+    using Valor = typename E1::Valor;
+    using Indice = typename E1::Indice;
+
+private:
+    E1 esquerda;
+    E2 direita;
+    mutable std::shared_ptr<AcumuladorLinha<Valor, Indice>> linhaEsquerda;
+    mutable std::vector<Indice> cols;
+    mutable std::vector<Valor> vals;
+
+    template <typename F>
+    void percorrerEsquerda(const ExprMatriz<Valor, Indice>& e, Indice i, F f) const {
+        e.paraCadaElemento(i, f);
+    }
+
+    template <typename E, typename F>
+    void percorrerEsquerda(const E& e, Indice i, F f) const {
+        if (!linhaEsquerda) {
+            linhaEsquerda = std::make_shared<AcumuladorLinha<Valor, Indice>>(e.colunas());
+        }
+        e.acumularLinha(i, Valor(1), *linhaEsquerda);
+        linhaEsquerda->extrair(cols, vals);
+        for (std::size_t k = 0; k < cols.size(); ++k) {
+            f(cols[k], vals[k]);
+        }
+    }
+
+public:
+    ExprProduto(const E1& a, const E2& b) : esquerda(a), direita(b) {
+        if (a.colunas() != b.linhas()) {
+            throw std::runtime_error("As matrizes tem dimensoes incompativeis para multiplicacao.");
+        }
+    }
+
+    Indice linhas() const { return esquerda.linhas(); }
+    Indice colunas() const { return direita.colunas(); }
+    bool usa(const void* matriz) const { return esquerda.usa(matriz) || direita.usa(matriz); }
+
+    void acumularLinha(Indice i, Valor coef, AcumuladorLinha<Valor, Indice>& acumulador) const {
+        percorrerEsquerda(esquerda, i, [&](Indice k, Valor v) { direita.acumularLinha(k, coef * v, acumulador); });
+    }
+};
+
+// Embrulha uma matriz em uma expressão, sem copiá-la
+template <typename T, typename Index>
+ExprMatriz<T, Index> expressao(const SparseMatrixT<T, Index>& A) { return ExprMatriz<T, Index>(A); }
+
+// Expressão da transposta de uma matriz, sem transpô-la
+template <typename T, typename Index>
+ExprTransposta<T, Index> transposta(const SparseMatrixT<T, Index>& A) { return ExprTransposta<T, Index>(A); }
+
+template <typename E1, typename E2>
+ExprSoma<E1, E2> operator+(const Expressao<E1>& a, const Expressao<E2>& b) {
+    return ExprSoma<E1, E2>(a.derivada(), b.derivada());
+}
+
+template <typename E1, typename E2>
+ExprSoma<E1, ExprEscala<E2>> operator-(const Expressao<E1>& a, const Expressao<E2>& b) {
+    return ExprSoma<E1, ExprEscala<E2>>(a.derivada(), ExprEscala<E2>(b.derivada(), typename E2::Valor(-1)));
+}
+
+template <typename E1, typename E2>
+ExprProduto<E1, E2> operator*(const Expressao<E1>& a, const Expressao<E2>& b) {
+    return ExprProduto<E1, E2>(a.derivada(), b.derivada());
+}
+
+template <typename E>
+ExprEscala<E> operator*(typename E::Valor alpha, const Expressao<E>& e) {
+    return ExprEscala<E>(e.derivada(), alpha);
+}
+
+template <typename E>
+ExprEscala<E> operator*(const Expressao<E>& e, typename E::Valor alpha) {
+    return ExprEscala<E>(e.derivada(), alpha);
+}
+
+/* Avalia a expressão em uma nova matriz
+ * Calcula cada linha do resultado no acumulador, em uma única passada por todos os nós da expressão,
+ * e a grava de uma só vez, já ordenada e sem zeros; nenhuma matriz intermediária é criada
+ * As linhas são gravadas com somarLinha, sem ligar as colunas; elas são religadas uma única vez ao final
+ */
+template <typename E>
+SparseMatrixT<typename E::Valor, typename E::Indice> avaliar(const Expressao<E>& expr) {
+    using T = typename E::Valor;
+    using Index = typename E::Indice;
+    const E& e = expr.derivada();
+
+    SparseMatrixT<T, Index> resultado(e.linhas(), e.colunas());
+    AcumuladorLinha<T, Index> acumulador(e.colunas());
+    std::vector<Index> cols;
+    std::vector<T> vals;
+    for (Index i = 1; i <= e.linhas(); ++i) {
+        e.acumularLinha(i, T(1), acumulador);
+        acumulador.extrair(cols, vals);
+        if (!cols.empty()) {
+            resultado.somarLinha(i, cols.data(), vals.data(), static_cast<Index>(cols.size()));
+        }
+    }
+    resultado.religarColunas();
+    return resultado;
+}
+
+/* Soma a expressão a C, no próprio lugar (C += e)
+ * Calcula cada linha da expressão no acumulador e a intercala na linha correspondente de C com somarLinha,
+ * sem criar nenhuma matriz intermediária: C += A * B acumula o produto direto nas linhas de C;
+ * as colunas de C são religadas uma única vez ao final
+ * Se a expressão lê a própria C, as linhas já alteradas seriam lidas de novo; nesse caso a expressão
+ * é avaliada antes em uma matriz separada
+ */
+template <typename T, typename Index, typename E>
+SparseMatrixT<T, Index>& operator+=(SparseMatrixT<T, Index>& C, const Expressao<E>& expr) {
+    const E& e = expr.derivada();
+    if (C.getLinhas() != e.linhas() || C.getColunas() != e.colunas()) {
+        throw std::runtime_error("As matrizes tem dimensoes incompativeis para soma.");
+    }
+    if (e.usa(&C)) {
+        return C += avaliar(expr);
+    }
+
+    AcumuladorLinha<T, Index> acumulador(e.colunas());
+    std::vector<Index> cols;
+    std::vector<T> vals;
+    for (Index i = 1; i <= e.linhas(); ++i) {
+        e.acumularLinha(i, T(1), acumulador);
+        acumulador.extrair(cols, vals);
+        if (!cols.empty()) {
+            C.somarLinha(i, cols.data(), vals.data(), static_cast<Index>(cols.size()));
+        }
+    }
+    C.religarColunas();
+    return C;
+}
+
+#endif
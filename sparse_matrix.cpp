@@ -1,197 +1,1030 @@
 #include "sparse_matrix.h"
+#include "matrix_types.h"
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
 
 using namespace std;
 
 /* Constrói uma matriz esparsa vazia com m linhas e n colunas
  * Verifica se os valores são válidos, lançando uma exceção se não forem
  * Cria um nó sentinela principal que servirá como referência
- * Inicializa nós sentinelas para cada linha, fazendo uma conexão circular
- * Inicializa nós sentinelas para cada coluna, fazendo uma conexão circular
+ * Cria os sentinelas das linhas e das colunas e zera as contagens de elementos
  */
-SparseMatrix::SparseMatrix(int m, int n) : linhas(m), colunas(n) {
+template <typename T, typename Index>
+SparseMatrixT<T, Index>::SparseMatrixT(Index m, Index n)
+    : linhas(m), colunas(n), m_linhas(nullptr), m_colunas(nullptr), m_fim_colunas(nullptr),
+      m_colunas_validas(true), m_csr(nullptr), m_csc(nullptr), m_contagens_validas(true), m_banda(0),
+      m_banda_valida(true) {
     if (m <= 0 || n <= 0) {
         throw invalid_argument("Erro: Dimensoes invalidas! Linhas e colunas devem ser maiores que zero.");
     }
     
     m_head = new Node();
+    criarSentinelas();
+    zerarContagens();
+}
+
+/* Constrói uma matriz já congelada sobre vetores CSR que pertencem a outro objeto
+ * Verifica se as dimensões são válidas e se a forma CSC, quando informada, corresponde à transposta
+ * Guarda as visões e o dono dos vetores, sem copiar nenhum elemento
+ * Não cria os sentinelas das linhas e das colunas: eles só são alocados se a matriz for descongelada,
+ * de modo que o custo não depende do tamanho da matriz; pelo mesmo motivo, as contagens de elementos
+ * por linha e por coluna e a banda só são calculadas quando forem pedidas, uma única vez mesmo que
+ * várias threads as peçam ao mesmo tempo
+ */
+template <typename T, typename Index>
+SparseMatrixT<T, Index>::SparseMatrixT(const CSRView& csr, const CSRView& csc, shared_ptr<const void> dono)
+    : linhas(csr.linhas), colunas(csr.colunas), m_linhas(nullptr), m_colunas(nullptr), m_fim_colunas(nullptr),
+      m_colunas_validas(true), m_csr(nullptr), m_csc(nullptr), m_vista_csr(csr), m_vista_csc(csc), m_dono(move(dono)),
+      m_contagens_validas(false), m_banda(0), m_banda_valida(false) {
+    if (linhas <= 0 || colunas <= 0 || !csr.row_ptr) {
+        throw invalid_argument("Erro: Dimensoes invalidas! Linhas e colunas devem ser maiores que zero.");
+    }
+    if (csc.row_ptr && (csc.linhas != colunas || csc.colunas != linhas)) {
+        throw invalid_argument("Erro: A forma CSC nao corresponde a matriz.");
+    }
+
+    m_head = new Node();
+}
+
+/* Aloca os sentinelas das linhas e das colunas em dois blocos contíguos,
+ * permitindo localizar a linha i ou a coluna j em tempo constante
+ * Encadeia os sentinelas das linhas e das colunas de forma circular
+ * Cada coluna começa vazia, com o próprio sentinela como último nó
+ * Não faz nada se os sentinelas já existirem
+ */
+template <typename T, typename Index>
+void SparseMatrixT<T, Index>::criarSentinelas() {
+    if (m_linhas) return;
+
+    m_linhas = new Node[linhas];
+    m_colunas = new Node[colunas];
+    m_fim_colunas = new Node*[colunas];
 
     Node* linha_sentinela = m_head;
-    for (int i = 1; i <= m; ++i) {
-        Node* nova_linha = new Node(i, 0);
+    for (Index i = 1; i <= linhas; ++i) {
+        Node* nova_linha = getLinha(i);
+        nova_linha->linha = i;
+        nova_linha->coluna = 0;
         linha_sentinela->abaixo = nova_linha;
         linha_sentinela = nova_linha;
     }
     linha_sentinela->abaixo = m_head;
 
     Node* coluna_sentinela = m_head;
-    for (int j = 1; j <= n; ++j) {
-        Node* nova_coluna = new Node(0, j);
+    for (Index j = 1; j <= colunas; ++j) {
+        Node* nova_coluna = getColuna(j);
+        nova_coluna->linha = 0;
+        nova_coluna->coluna = j;
+        m_fim_colunas[j - 1] = nova_coluna;
         coluna_sentinela->direita = nova_coluna;
         coluna_sentinela = nova_coluna;
     }
     coluna_sentinela->direita = m_head;
 }
 
+/* Constrói uma matriz esparsa com as dimensões e os elementos de uma matriz CSR
+ * Delega a criação dos sentinelas ao construtor principal
+ * Preenche as linhas de cima para baixo, cada uma de uma só vez
+ */
+template <typename T, typename Index>
+SparseMatrixT<T, Index>::SparseMatrixT(const CSRView& csr) : SparseMatrixT(csr.linhas, csr.colunas) {
+    carregarCSR(csr);
+}
+
+/* Constrói uma cópia independente de outra matriz
+ * Congelada: copia as formas que pertencem à outra matriz, como a forma CSC montada por freeze(true) sobre um
+ * arquivo mapeado; as que pertencem a outro dono são somente leitura, então a cópia apenas compartilha o dono,
+ * sem copiá-las; em nenhum caso aloca sentinelas, e copia as contagens de elementos e a banda que já forem válidas
+ * Descongelada: cria os sentinelas e copia cada linha de uma só vez, de cima para baixo, como na
+ * construção a partir da forma CSR, sem montar uma cópia intermediária da matriz inteira
+ */
+template <typename T, typename Index>
+SparseMatrixT<T, Index>::SparseMatrixT(const SparseMatrixT& outra)
+    : linhas(outra.linhas), colunas(outra.colunas), m_head(new Node()), m_linhas(nullptr), m_colunas(nullptr),
+      m_fim_colunas(nullptr), m_colunas_validas(true), m_csr(nullptr), m_csc(nullptr), m_contagens_validas(true), m_banda(0),
+      m_banda_valida(true) {
+    if (outra.isFrozen()) {
+        m_contagens_validas = outra.m_contagens_validas.load(memory_order_acquire);
+        if (m_contagens_validas) {
+            m_nnz_linhas = outra.m_nnz_linhas;
+            m_nnz_colunas = outra.m_nnz_colunas;
+        }
+        m_banda_valida = outra.m_banda_valida.load(memory_order_acquire);
+        if (m_banda_valida) m_banda = outra.m_banda;
+        m_dono = outra.m_dono;
+        m_vista_csr = outra.m_vista_csr;
+        m_vista_csc = outra.m_vista_csc;
+        if (outra.m_csr) {
+            m_csr = new CSRMatrix(*outra.m_csr);
+            m_vista_csr = *m_csr;
+        }
+        if (outra.m_csc) {
+            m_csc = new CSRMatrix(*outra.m_csc);
+            m_vista_csc = *m_csc;
+        }
+        return;
+    }
+
+    criarSentinelas();
+    zerarContagens();
+    vector<Index> cols;
+    vector<T> valores;
+    for (Index i = 1; i <= linhas; ++i) {
+        cols.clear();
+        valores.clear();
+        Node* linha_sentinela = outra.getLinha(i);
+        for (Node* elemento = linha_sentinela->direita; elemento != linha_sentinela; elemento = elemento->direita) {
+            cols.push_back(elemento->coluna);
+            valores.push_back(elemento->valor);
+        }
+        inserirLinha(i, cols, valores);
+    }
+}
+
+/* Constrói a matriz tomando o conteúdo de outra, sem copiar nenhum elemento
+ * Começa vazia, sem nó sentinela principal, e troca de conteúdo com a outra matriz,
+ * que fica no estado vazio e é destruída sem liberar nada
+ */
+template <typename T, typename Index>
+SparseMatrixT<T, Index>::SparseMatrixT(SparseMatrixT&& outra) noexcept
+    : linhas(0), colunas(0), m_head(nullptr), m_linhas(nullptr), m_colunas(nullptr), m_fim_colunas(nullptr),
+      m_colunas_validas(true), m_csr(nullptr), m_csc(nullptr), m_contagens_validas(true), m_banda(0),
+      m_banda_valida(true) {
+    trocar(outra);
+}
+
+/* Atribui outra matriz a esta
+ * O parâmetro já é a cópia (ou a matriz movida); basta trocar de conteúdo com ele,
+ * e o conteúdo antigo desta matriz é liberado quando o parâmetro é destruído
+ */
+template <typename T, typename Index>
+SparseMatrixT<T, Index>& SparseMatrixT<T, Index>::operator=(SparseMatrixT outra) noexcept {
+    trocar(outra);
+    return *this;
+}
+
+/* Troca todos os membros com outra matriz
+ * Os nós, os sentinelas e as formas comprimidas ficam onde estão; só os ponteiros mudam de dono
+ * A trava do cálculo tardio não é trocada: cada objeto mantém a sua
+ */
+template <typename T, typename Index>
+void SparseMatrixT<T, Index>::trocar(SparseMatrixT& outra) noexcept {
+    swap(linhas, outra.linhas);
+    swap(colunas, outra.colunas);
+    swap(m_head, outra.m_head);
+    swap(m_linhas, outra.m_linhas);
+    swap(m_colunas, outra.m_colunas);
+    swap(m_fim_colunas, outra.m_fim_colunas);
+    swap(m_colunas_validas, outra.m_colunas_validas);
+    m_pool.trocar(outra.m_pool);
+    swap(m_csr, outra.m_csr);
+    swap(m_csc, outra.m_csc);
+    swap(m_vista_csr, outra.m_vista_csr);
+    swap(m_vista_csc, outra.m_vista_csc);
+    m_dono.swap(outra.m_dono);
+    m_nnz_linhas.swap(outra.m_nnz_linhas);
+    m_nnz_colunas.swap(outra.m_nnz_colunas);
+    m_contagens_validas = outra.m_contagens_validas.exchange(m_contagens_validas);
+    swap(m_banda, outra.m_banda);
+    m_banda_valida = outra.m_banda_valida.exchange(m_banda_valida);
+    PERFIL(m_perfil.trocar(outra.m_perfil);)
+}
+
 /* Destrói a matriz esparsa liberando toda a memória alocada
  * Chama a função auxiliar desalocar() para remover todos os nós
  * Garante que nenhum nó fique alocado após a destruição do objeto
  */
-SparseMatrix::~SparseMatrix() {
+template <typename T, typename Index>
+SparseMatrixT<T, Index>::~SparseMatrixT() {
     desalocar();
 }
 
 /* Libera toda a memória alocada pela matriz
- * Percorre todas as linhas, removendo seus elementos e nós sentinelas
- * Percorre todas as colunas, removendo os nós sentinelas das colunas
+ * Os elementos não nulos são liberados em bloco pelo pool de nós
+ * Descarta as formas comprimidas, caso a matriz esteja congelada
+ * Libera os blocos de sentinelas das linhas e das colunas
  * Remove o nó sentinela principal, finalizando a desalocação
  */
-void SparseMatrix::desalocar() {
+template <typename T, typename Index>
+void SparseMatrixT<T, Index>::desalocar() {
     if (!m_head) return;
 
-    Node* linha_sentinela = m_head->abaixo;
-    while (linha_sentinela != m_head) {
-        Node* elemento = linha_sentinela->direita;
-        while (elemento != linha_sentinela) {
-            Node* temp = elemento;
-            elemento = elemento->direita;
-            delete temp;
-        }
-        Node* tempLinha = linha_sentinela;
-        linha_sentinela = linha_sentinela->abaixo;
-        delete tempLinha;
-    }
-
-    Node* coluna_sentinela = m_head->direita;
-    while (coluna_sentinela != m_head) {
-        Node* tempColuna = coluna_sentinela;
-        coluna_sentinela = coluna_sentinela->direita;
-        delete tempColuna;
-    }
-
+    m_pool.liberarTudo();
+    descartarFormas();
+    delete[] m_linhas;
+    delete[] m_colunas;
+    delete[] m_fim_colunas;
     delete m_head;
 }
 
 /* Função que insere ou atualiza um valor na matriz
- * Se o valor for zero, a função retorna sem fazer nada
  * Verifica se os índices são válidos, lançando uma exceção se não forem
- * Percorre os nós sentinelas para encontrar a linha correspondente
+ * Se o valor for zero, remove o elemento da posição, já que a matriz não guarda zeros
+ * Descongela a matriz antes da alteração, se necessário
+ * Obtém diretamente o nó sentinela da linha correspondente
  * Dentro da linha, avança até a posição correta da coluna
  * Se já existir um elemento na posição (i, j), atualiza seu valor
- * Caso contrário, cria um novo nó e o insere na estrutura
+ * Caso contrário, cria um novo nó, o insere na linha e na coluna e o conta nas estatísticas
  */
-void SparseMatrix::inserir(int i, int j, double value) {
+template <typename T, typename Index>
+void SparseMatrixT<T, Index>::inserir(Index i, Index j, T value) {
     if (i < 1 || i > linhas || j < 1 || j > colunas) {
         throw out_of_range("Erro: Indices fora dos limites da matriz.");
     }
-    if (value == 0) return;
-
-    Node* linha_sentinela = m_head;
-    for (int k = 1; k <= i; ++k) {
-        linha_sentinela = linha_sentinela->abaixo;
+    if (value == T()) {
+        remover(i, j);
+        return;
     }
+    if (isFrozen()) thaw();
 
+    Node* linha_sentinela = getLinha(i);
+
+    PERFIL(long long saltos = 0;)
     Node* elemento = linha_sentinela;
     while (elemento->direita != linha_sentinela && elemento->direita->coluna < j) {
         elemento = elemento->direita;
+        PERFIL(++saltos;)
     }
+    PERFIL(PerfilMatriz::somar(m_perfil.saltos, saltos); PerfilMatriz::somar(m_perfil.insercoes, 1);)
 
     if (elemento->direita != linha_sentinela && elemento->direita->coluna == j) {
         elemento->direita->valor = value;
     } else {
-        Node* novo = new Node(i, j, value);
+        Node* novo = m_pool.alocar(i, j, value);
         novo->direita = elemento->direita;
         elemento->direita = novo;
+        ligarNaColuna(novo);
+        contarElemento(i, j);
+    }
+}
+
+/* Conta um elemento recém-criado na sua linha e na sua coluna
+ * Alarga a banda se o elemento estiver mais longe da diagonal que os demais
+ */
+template <typename T, typename Index>
+void SparseMatrixT<T, Index>::contarElemento(Index i, Index j) {
+    ++m_nnz_linhas[i - 1];
+    ++m_nnz_colunas[j - 1];
+    if (m_banda_valida.load(memory_order_relaxed)) {
+        m_banda = max(m_banda, abs(i - j));
+    }
+}
+
+/* Desconta um elemento removido da sua linha e da sua coluna
+ * Se o elemento estava na borda da banda, ela pode ter diminuído: será recalculada quando for pedida
+ */
+template <typename T, typename Index>
+void SparseMatrixT<T, Index>::descontarElemento(Index i, Index j) {
+    --m_nnz_linhas[i - 1];
+    --m_nnz_colunas[j - 1];
+    if (abs(i - j) == m_banda) {
+        m_banda_valida.store(false, memory_order_relaxed);
+    }
+}
+
+/* Zera as contagens de todas as linhas e colunas, alocando-as se ainda não existirem
+ * A matriz sem elementos tem banda zero
+ */
+template <typename T, typename Index>
+void SparseMatrixT<T, Index>::zerarContagens() {
+    m_nnz_linhas.assign(linhas, 0);
+    m_nnz_colunas.assign(colunas, 0);
+    m_contagens_validas.store(true, memory_order_relaxed);
+    m_banda = 0;
+    m_banda_valida.store(true, memory_order_relaxed);
+}
+
+/* Calcula as contagens de uma matriz construída congelada, na primeira vez em que forem pedidas
+ * Várias threads podem ler a matriz ao mesmo tempo: só uma calcula, sob a trava, e as demais esperam;
+ * depois que as contagens ficam válidas, a verificação inicial não toma mais a trava
+ * As contagens das linhas vêm de row_ptr; as das colunas, da forma CSC, se existir,
+ * ou de uma passada pelas colunas da forma CSR
+ */
+template <typename T, typename Index>
+void SparseMatrixT<T, Index>::calcularContagens() const {
+    if (m_contagens_validas.load(memory_order_acquire)) return;
+    lock_guard<mutex> trava(m_trava_calculo);
+    if (m_contagens_validas.load(memory_order_relaxed)) return;
+
+    m_nnz_linhas.resize(linhas);
+    for (Index i = 1; i <= linhas; ++i) {
+        m_nnz_linhas[i - 1] = m_vista_csr.row_ptr[i] - m_vista_csr.row_ptr[i - 1];
+    }
+    m_nnz_colunas.assign(colunas, 0);
+    if (getCSC()) {
+        for (Index j = 1; j <= colunas; ++j) {
+            m_nnz_colunas[j - 1] = m_vista_csc.row_ptr[j] - m_vista_csc.row_ptr[j - 1];
+        }
+    } else {
+        for (Index k = 0; k < m_vista_csr.nnz(); ++k) {
+            ++m_nnz_colunas[m_vista_csr.col_idx[k] - 1];
+        }
+    }
+    m_contagens_validas.store(true, memory_order_release);
+}
+
+/* Retorna a banda, recalculando-a se um elemento na sua borda foi removido ou se a matriz foi construída congelada
+ * O recálculo usa o primeiro e o último elemento de cada linha e é feito sob a trava, como o das contagens
+ */
+template <typename T, typename Index>
+Index SparseMatrixT<T, Index>::calcularBanda() const {
+    if (m_banda_valida.load(memory_order_acquire)) return m_banda;
+    lock_guard<mutex> trava(m_trava_calculo);
+    if (m_banda_valida.load(memory_order_relaxed)) return m_banda;
+
+    Index banda = 0;
+    for (Index i = 1; i <= linhas; ++i) {
+        if (isFrozen()) {
+            Index inicio = m_vista_csr.row_ptr[i - 1], fim = m_vista_csr.row_ptr[i];
+            if (inicio == fim) continue;
+            banda = max({banda, abs(i - m_vista_csr.col_idx[inicio]), abs(m_vista_csr.col_idx[fim - 1] - i)});
+        } else {
+            Node* linha_sentinela = getLinha(i);
+            for (Node* elemento = linha_sentinela->direita; elemento != linha_sentinela; elemento = elemento->direita) {
+                banda = max(banda, abs(i - elemento->coluna));
+            }
+        }
+    }
+    m_banda = banda;
+    m_banda_valida.store(true, memory_order_release);
+    return banda;
+}
+
+/* Remove o elemento da posição (i, j)
+ * Verifica se os índices são válidos, lançando uma exceção se não forem
+ * Se a posição estiver vazia, retorna sem alterar a matriz (e sem descongelá-la)
+ * Procura o elemento e o seu antecessor na linha e o desliga dela
+ * Se as colunas estiverem em dia, procura o antecessor na coluna, desliga o nó e atualiza o último nó
+ * da coluna, caso fosse ele; senão, o nó sairá da coluna quando ela for religada
+ * Desconta o elemento das estatísticas e devolve o nó ao pool
+ */
+template <typename T, typename Index>
+void SparseMatrixT<T, Index>::remover(Index i, Index j) {
+    PERFIL(PerfilMatriz::somar(m_perfil.remocoes, 1);)
+    if (get(i, j) == T()) return;
+    if (isFrozen()) thaw();
+
+    PERFIL(long long saltos = 0;)
+    Node* linha_sentinela = getLinha(i);
+    Node* anterior = linha_sentinela;
+    while (anterior->direita->coluna != j) {
+        anterior = anterior->direita;
+        PERFIL(++saltos;)
+    }
+    Node* elemento = anterior->direita;
+    anterior->direita = elemento->direita;
+
+    if (m_colunas_validas) {
+        Node* coluna_sentinela = getColuna(j);
+        Node* acima = coluna_sentinela;
+        while (acima->abaixo != elemento) {
+            acima = acima->abaixo;
+            PERFIL(++saltos;)
+        }
+        acima->abaixo = elemento->abaixo;
+        if (m_fim_colunas[j - 1] == elemento) {
+            m_fim_colunas[j - 1] = acima;
+        }
+    }
+
+    PERFIL(PerfilMatriz::somar(m_perfil.saltos, saltos);)
+    descontarElemento(i, j);
+    m_pool.liberar(elemento);
+}
+
+/* Remove todos os elementos com valor absoluto até epsilon, como os restos de cancelamentos numéricos
+ * Lança uma exceção se epsilon for negativo
+ * Congelada: monta uma nova forma CSR só com os elementos que ficam (e uma nova CSC, se ela existia)
+ * Descongelada: percorre cada linha uma vez, desligando os nós removidos e devolvendo-os ao pool;
+ * as colunas não são percorridas nó a nó: são religadas ao final, em uma única passada, e a matriz sai consistente
+ * O custo é proporcional aos elementos não nulos mais o número de linhas
+ */
+template <typename T, typename Index>
+Index SparseMatrixT<T, Index>::prune(double epsilon) {
+    if (epsilon < 0) {
+        throw invalid_argument("Erro: A tolerancia deve ser maior ou igual a zero.");
+    }
+
+    Index removidos = 0;
+    if (isFrozen()) {
+        CSRMatrix* compacta = new CSRMatrix();
+        compacta->linhas = linhas;
+        compacta->colunas = colunas;
+        compacta->row_ptr.reserve(linhas + 1);
+        compacta->row_ptr.push_back(0);
+        for (Index i = 1; i <= linhas; ++i) {
+            for (Index k = m_vista_csr.row_ptr[i - 1]; k < m_vista_csr.row_ptr[i]; ++k) {
+                if (abs(m_vista_csr.values[k]) > epsilon) {
+                    compacta->col_idx.push_back(m_vista_csr.col_idx[k]);
+                    compacta->values.push_back(m_vista_csr.values[k]);
+                }
+            }
+            compacta->row_ptr.push_back(compacta->nnz());
+        }
+        removidos = m_vista_csr.nnz() - compacta->nnz();
+        if (removidos == 0) {
+            delete compacta;
+            return 0;
+        }
+
+        bool comCSC = getCSC() != nullptr;
+        descartarFormas();
+        m_csr = compacta;
+        m_vista_csr = *m_csr;
+        m_nnz_linhas.clear();
+        m_nnz_colunas.clear();
+        m_contagens_validas.store(false, memory_order_relaxed);
+        m_banda_valida.store(false, memory_order_relaxed);
+        if (comCSC) freeze(true);
+        return removidos;
+    }
+
+    for (Index i = 1; i <= linhas; ++i) {
+        Node* linha_sentinela = getLinha(i);
+        Node* anterior = linha_sentinela;
+        while (anterior->direita != linha_sentinela) {
+            Node* elemento = anterior->direita;
+            if (abs(elemento->valor) <= epsilon) {
+                anterior->direita = elemento->direita;
+                descontarElemento(i, elemento->coluna);
+                m_pool.liberar(elemento);
+                ++removidos;
+            } else {
+                anterior = elemento;
+            }
+        }
+    }
+    if (removidos > 0) {
+        m_colunas_validas = false;
+        religarColunas();
+    }
+    return removidos;
+}
+
+/* Encadeia um nó recém-criado na lista circular da sua coluna
+ * Se o nó pertence a uma linha abaixo do último elemento da coluna, liga-o no final em tempo constante
+ * Caso contrário, percorre a coluna a partir do sentinela até a posição correta da linha
+ * Atualiza o último nó da coluna quando o novo nó passa a ocupar essa posição
+ * Se as colunas estiverem desatualizadas, não faz nada: o nó será ligado quando elas forem religadas
+ */
+template <typename T, typename Index>
+void SparseMatrixT<T, Index>::ligarNaColuna(Node* novo) {
+    if (!m_colunas_validas) return;
+
+    Node* coluna_sentinela = getColuna(novo->coluna);
+    Node*& fim = m_fim_colunas[novo->coluna - 1];
+
+    Node* anterior = fim;
+    if (fim != coluna_sentinela && fim->linha > novo->linha) {
+        anterior = coluna_sentinela;
+        PERFIL(long long saltos = 0;)
+        while (anterior->abaixo != coluna_sentinela && anterior->abaixo->linha < novo->linha) {
+            anterior = anterior->abaixo;
+            PERFIL(++saltos;)
+        }
+        PERFIL(PerfilMatriz::somar(m_perfil.saltos, saltos);)
+    }
+
+    novo->abaixo = anterior->abaixo;
+    anterior->abaixo = novo;
+    if (anterior == fim) {
+        fim = novo;
+    }
+}
+
+/* Preenche de uma só vez a linha i, que precisa estar vazia
+ * Verifica os índices e exige colunas em ordem estritamente crescente, lançando exceções se não estiverem
+ * Descongela a matriz antes da alteração, se necessário
+ * Ignora valores nulos, preservando a ausência de zeros na estrutura
+ * Encadeia os novos nós em sequência na linha, sem percorrê-la a cada elemento
+ * Quando as linhas são preenchidas de cima para baixo, cada nó entra no final da sua coluna em tempo constante
+ */
+template <typename T, typename Index>
+void SparseMatrixT<T, Index>::inserirLinha(Index i, const Index* cols, const T* valores, Index n) {
+    if (i < 1 || i > linhas) {
+        throw out_of_range("Erro: Indices fora dos limites da matriz.");
+    }
+    if (isFrozen()) thaw();
+
+    Node* linha_sentinela = getLinha(i);
+    if (linha_sentinela->direita != linha_sentinela) {
+        throw logic_error("Erro: A linha precisa estar vazia para ser preenchida de uma vez.");
+    }
+
+    Index coluna_anterior = 0;
+    for (Index k = 0; k < n; ++k) {
+        if (cols[k] <= coluna_anterior || cols[k] > colunas) {
+            throw out_of_range("Erro: Colunas fora dos limites ou fora de ordem.");
+        }
+        coluna_anterior = cols[k];
+    }
+
+    Node* ultimo = linha_sentinela;
+    for (Index k = 0; k < n; ++k) {
+        if (valores[k] == T()) continue;
+
+        Node* novo = m_pool.alocar(i, cols[k], valores[k]);
+        ultimo->direita = novo;
+        ultimo = novo;
+        ligarNaColuna(novo);
+        contarElemento(i, cols[k]);
+    }
+    ultimo->direita = linha_sentinela;
+}
+
+/* Versão de inserirLinha que recebe as colunas e os valores em vetores
+ * Verifica se os dois vetores têm o mesmo tamanho, lançando uma exceção se não tiverem
+ */
+template <typename T, typename Index>
+void SparseMatrixT<T, Index>::inserirLinha(Index i, const vector<Index>& cols, const vector<T>& valores) {
+    if (cols.size() != valores.size()) {
+        throw invalid_argument("Erro: Quantidade de colunas e de valores diferentes.");
+    }
+    inserirLinha(i, cols.data(), valores.data(), static_cast<Index>(cols.size()));
+}
+
+/* Soma alpha * B a esta matriz, alterando-a no próprio lugar
+ * Verifica se as dimensões são compatíveis, lançando uma exceção se não forem
+ * Descongela a matriz antes da alteração, se necessário; B pode estar congelada
+ * Percorre as linhas de cima para baixo, intercalando a linha de B na linha correspondente desta matriz
+ * com mesclarLinha: elementos de mesma coluna são somados e as somas nulas são removidas
+ * Se a estrutura mudou, religa as colunas ao final, em uma única passada, em vez de a cada nó ou a cada soma
+ * O custo total é proporcional aos elementos não nulos das duas matrizes, mais o número de linhas e colunas
+ */
+template <typename T, typename Index>
+void SparseMatrixT<T, Index>::axpy(T alpha, const SparseMatrixT& B) {
+    if (linhas != B.linhas || colunas != B.colunas) {
+        throw runtime_error("As matrizes tem dimensoes incompativeis para soma.");
+    }
+    if (alpha == T()) return;
+    if (isFrozen()) thaw();
+
+    if (&B == this) {
+        if (alpha == T(-1)) {
+            clear();
+            return;
+        }
+        for (Index i = 1; i <= linhas; ++i) {
+            Node* linha_sentinela = getLinha(i);
+            for (Node* elemento = linha_sentinela->direita; elemento != linha_sentinela; elemento = elemento->direita) {
+                elemento->valor *= T(1) + alpha;
+            }
+        }
+        return;
+    }
+
+    PERFIL(if (!B.isFrozen()) B.contarSaltos(static_cast<long long>(B.m_pool.emUso()) + linhas);)
+    bool estruturaAlterada = false;
+    vector<Index> cols;
+    vector<T> valores;
+    for (Index i = 1; i <= linhas; ++i) {
+        cols.clear();
+        valores.clear();
+        if (B.isFrozen()) {
+            const CSRView& csrB = B.m_vista_csr;
+            for (Index k = csrB.row_ptr[i - 1]; k < csrB.row_ptr[i]; ++k) {
+                cols.push_back(csrB.col_idx[k]);
+                valores.push_back(alpha * csrB.values[k]);
+            }
+        } else {
+            Node* linhaB = B.getLinha(i);
+            for (Node* elementoB = linhaB->direita; elementoB != linhaB; elementoB = elementoB->direita) {
+                cols.push_back(elementoB->coluna);
+                valores.push_back(alpha * elementoB->valor);
+            }
+        }
+
+        if (mesclarLinha(i, cols.data(), valores.data(), static_cast<Index>(cols.size()))) {
+            estruturaAlterada = true;
+        }
+    }
+
+    if (estruturaAlterada) {
+        m_colunas_validas = false;
+        religarColunas();
+    }
+}
+
+/* Intercala n elementos, com colunas em ordem crescente, na linha i, somando os de mesma coluna
+ * Elementos de mesma coluna são somados, os demais viram nós novos encadeados entre os existentes
+ * Elementos cuja soma resulta em zero são desligados da linha e devolvidos ao pool
+ * As contagens de elementos acompanham cada nó criado ou removido; as colunas não são tocadas
+ * Retorna verdadeiro se algum nó foi criado ou removido
+ */
+template <typename T, typename Index>
+bool SparseMatrixT<T, Index>::mesclarLinha(Index i, const Index* cols, const T* valores, Index n) {
+    bool estruturaAlterada = false;
+    PERFIL(long long saltos = 0;)
+    Node* linha_sentinela = getLinha(i);
+    Node* anterior = linha_sentinela;
+    for (Index k = 0; k < n; ++k) {
+        Index j = cols[k];
+        while (anterior->direita != linha_sentinela && anterior->direita->coluna < j) {
+            anterior = anterior->direita;
+            PERFIL(++saltos;)
+        }
+
+        Node* atual = anterior->direita;
+        if (atual != linha_sentinela && atual->coluna == j) {
+            atual->valor += valores[k];
+            if (atual->valor == T()) {
+                anterior->direita = atual->direita;
+                descontarElemento(i, j);
+                m_pool.liberar(atual);
+                estruturaAlterada = true;
+            }
+        } else if (valores[k] != T()) {
+            Node* novo = m_pool.alocar(i, j, valores[k]);
+            novo->direita = atual;
+            anterior->direita = novo;
+            anterior = novo;
+            contarElemento(i, j);
+            estruturaAlterada = true;
+        }
+    }
+    PERFIL(PerfilMatriz::somar(m_perfil.saltos, saltos);)
+    return estruturaAlterada;
+}
+
+/* Soma à linha i, no próprio lugar, uma linha com colunas em ordem estritamente crescente
+ * Verifica os índices e a ordem das colunas, lançando exceções se forem inválidos
+ * Descongela a matriz antes da alteração, se necessário
+ * Se a estrutura mudou, marca as colunas como desatualizadas, sem religá-las: quem soma várias linhas
+ * chama religarColunas uma única vez ao final
+ * O custo é proporcional aos elementos da linha i mais n
+ */
+template <typename T, typename Index>
+void SparseMatrixT<T, Index>::somarLinha(Index i, const Index* cols, const T* valores, Index n) {
+    if (i < 1 || i > linhas) {
+        throw out_of_range("Erro: Indices fora dos limites da matriz.");
+    }
+    Index coluna_anterior = 0;
+    for (Index k = 0; k < n; ++k) {
+        if (cols[k] <= coluna_anterior || cols[k] > colunas) {
+            throw out_of_range("Erro: Colunas fora dos limites ou fora de ordem.");
+        }
+        coluna_anterior = cols[k];
     }
+    if (isFrozen()) thaw();
+
+    if (mesclarLinha(i, cols, valores, n)) {
+        m_colunas_validas = false;
+    }
+}
+
+/* Reconstrói os encadeamentos de todas as colunas a partir das linhas
+ * Não faz nada se as colunas já estiverem ligadas
+ * Percorre as linhas de cima para baixo, ligando cada nó ao final da sua coluna
+ * Fecha cada coluna circularmente no seu sentinela e atualiza o último nó de cada coluna
+ * O custo é proporcional aos elementos não nulos mais o número de linhas e colunas
+ */
+template <typename T, typename Index>
+void SparseMatrixT<T, Index>::religarColunas() {
+    if (m_colunas_validas || isFrozen()) return;
+
+    for (Index j = 1; j <= colunas; ++j) {
+        m_fim_colunas[j - 1] = getColuna(j);
+    }
+
+    for (Index i = 1; i <= linhas; ++i) {
+        Node* linha_sentinela = getLinha(i);
+        for (Node* elemento = linha_sentinela->direita; elemento != linha_sentinela; elemento = elemento->direita) {
+            Node*& fim = m_fim_colunas[elemento->coluna - 1];
+            fim->abaixo = elemento;
+            fim = elemento;
+        }
+    }
+
+    for (Index j = 1; j <= colunas; ++j) {
+        m_fim_colunas[j - 1]->abaixo = getColuna(j);
+    }
+    m_colunas_validas = true;
+    PERFIL(PerfilMatriz::somar(m_perfil.saltos, static_cast<long long>(m_pool.emUso()) + linhas);
+           PerfilMatriz::somar(m_perfil.religacoes, 1);)
 }
 
 /* Retorna o valor armazenado na posição (i, j) da matriz
  * Lança uma exceção se os índices forem inválidos
- * Percorre os nós sentinelas para localizar a linha correspondente
+ * Obtém diretamente o nó sentinela da linha correspondente
  * Dentro da linha, avança até encontrar a coluna desejada
+ * Se a matriz estiver congelada, faz uma busca binária na linha da forma CSR
  * Retorna o valor encontrado ou 0 caso a posição esteja vazia
  */
 
-double SparseMatrix::get(int i, int j) const {
+template <typename T, typename Index>
+T SparseMatrixT<T, Index>::get(Index i, Index j) const {
     if (i < 1 || i > linhas || j < 1 || j > colunas) {
         throw out_of_range("Erro: Indices fora dos limites da matriz.");
     }
+    PERFIL(PerfilMatriz::somar(m_perfil.consultas, 1);)
+    if (isFrozen()) return m_vista_csr.get(i, j);
 
-    Node* linha_sentinela = m_head;
-    for (int k = 1; k <= i; ++k) {
-        linha_sentinela = linha_sentinela->abaixo;
-    }
+    Node* linha_sentinela = getLinha(i);
 
+    PERFIL(long long saltos = 1;)
     Node* elemento = linha_sentinela->direita;
     while (elemento != linha_sentinela && elemento->coluna < j) {
         elemento = elemento->direita;
+        PERFIL(++saltos;)
     }
+    PERFIL(PerfilMatriz::somar(m_perfil.saltos, saltos);)
 
-    return (elemento != linha_sentinela && elemento->coluna == j) ? elemento->valor : 0.0;
+    return (elemento != linha_sentinela && elemento->coluna == j) ? elemento->valor : T();
 }
 
-/* Conta e retorna a quantidade de elementos não nulos na matriz
- * Percorre todas as linhas da matriz
- * Dentro de cada linha, percorre os elementos não nulos
- * Incrementa o contador para cada elemento encontrado
+/* Retorna a quantidade de elementos não nulos na matriz, sem percorrê-la
+ * Se a matriz estiver congelada, a quantidade é o tamanho da forma CSR
+ * Caso contrário, é a quantidade de nós em uso no pool, que só guarda elementos não nulos
  */
-int SparseMatrix::countNonZero() const {
-    int count = 0;
-    for (Node* linha = m_head->abaixo; linha != m_head; linha = linha->abaixo) {
-        Node* elemento = linha->direita;
-        while (elemento != linha) {
-            count++;
-            elemento = elemento->direita;
-        }
+template <typename T, typename Index>
+Index SparseMatrixT<T, Index>::countNonZero() const {
+    if (isFrozen()) return m_vista_csr.nnz();
+    return static_cast<Index>(m_pool.emUso());
+}
+
+/* Retorna a quantidade de elementos não nulos da linha i
+ * Lança uma exceção se o índice for inválido
+ */
+template <typename T, typename Index>
+Index SparseMatrixT<T, Index>::countNonZeroRow(Index i) const {
+    if (i < 1 || i > linhas) {
+        throw out_of_range("Erro: Indices fora dos limites da matriz.");
+    }
+    if (isFrozen()) return m_vista_csr.row_ptr[i] - m_vista_csr.row_ptr[i - 1];
+    return m_nnz_linhas[i - 1];
+}
+
+/* Retorna a quantidade de elementos não nulos da coluna j
+ * Lança uma exceção se o índice for inválido
+ */
+template <typename T, typename Index>
+Index SparseMatrixT<T, Index>::countNonZeroColumn(Index j) const {
+    if (j < 1 || j > colunas) {
+        throw out_of_range("Erro: Indices fora dos limites da matriz.");
+    }
+    calcularContagens();
+    return m_nnz_colunas[j - 1];
+}
+
+/* Reúne as estatísticas da estrutura da matriz
+ * A quantidade de elementos e as contagens por linha e por coluna são mantidas pela matriz;
+ * os máximos percorrem apenas as contagens, com custo proporcional a linhas + colunas
+ * A banda é mantida a cada inserção; se um elemento na sua borda foi removido (ou a matriz foi
+ * construída congelada), ela é recalculada uma vez pelo primeiro e pelo último elemento de cada linha
+ * Pode ser chamada por várias threads ao mesmo tempo, desde que nenhuma altere a matriz
+ */
+template <typename T, typename Index>
+EstatisticasMatriz SparseMatrixT<T, Index>::getEstatisticas() const {
+    calcularContagens();
+
+    EstatisticasMatriz e;
+    e.linhas = linhas;
+    e.colunas = colunas;
+    e.nnz = countNonZero();
+    e.maxLinha = *max_element(m_nnz_linhas.begin(), m_nnz_linhas.end());
+    e.maxColuna = *max_element(m_nnz_colunas.begin(), m_nnz_colunas.end());
+    e.mediaLinha = static_cast<double>(e.nnz) / linhas;
+    e.densidade = static_cast<double>(e.nnz) / (static_cast<double>(linhas) * colunas);
+
+    e.banda = calcularBanda();
+    return e;
+}
+
+/* Retorna a quantidade de bytes que a matriz mantém alocados
+ * Soma o nó sentinela principal, os sentinelas das linhas e das colunas (se existirem), os blocos do pool
+ * de nós, incluindo os nós livres, as contagens por linha e por coluna e as formas comprimidas que
+ * pertencem à matriz; os vetores de outro dono, como um arquivo mapeado, não são contados
+ */
+template <typename T, typename Index>
+size_t SparseMatrixT<T, Index>::bytesResidentes() const {
+    size_t total = sizeof(*this);
+    if (m_head) total += sizeof(Node);
+    if (m_linhas) {
+        total += (static_cast<size_t>(linhas) + colunas) * sizeof(Node) + colunas * sizeof(Node*);
     }
-    return count;
+    total += m_pool.bytes();
+    total += (m_nnz_linhas.capacity() + m_nnz_colunas.capacity()) * sizeof(Index);
+    if (m_csr) total += sizeof(CSRMatrix) + m_csr->bytes();
+    if (m_csc) total += sizeof(CSRMatrix) + m_csc->bytes();
+    return total;
 }
 
 /* Remove todos os elementos não nulos da matriz, mantendo a estrutura
- * Percorre cada linha da matriz e remove seus elementos não nulos
+ * Descarta as formas comprimidas, caso a matriz esteja congelada
+ * Esvazia as listas de linhas e colunas, criando os nós sentinelas se ainda não existirem
+ * Zera as contagens de elementos
+ */
+template <typename T, typename Index>
+void SparseMatrixT<T, Index>::clear() {
+    descartarFormas();
+    criarSentinelas();
+    esvaziarListas();
+    zerarContagens();
+}
+
+/* Descarta as formas comprimidas da matriz congelada
+ * Libera os vetores que pertencem à matriz e solta o dono dos demais
+ */
+template <typename T, typename Index>
+void SparseMatrixT<T, Index>::descartarFormas() {
+    delete m_csr;
+    delete m_csc;
+    m_csr = m_csc = nullptr;
+    m_vista_csr = m_vista_csc = CSRView();
+    m_dono.reset();
+}
+
+/* Libera todos os elementos de uma só vez pelo pool, sem percorrer as linhas
  * Mantém os nós sentinelas para preservar a estrutura da matriz
- * Reseta as conexões das linhas para garantir que fiquem vazias
+ * Reseta as conexões das linhas e das colunas para garantir que fiquem vazias
  */
-void SparseMatrix::clear() {
-    for (int i = 0; i < this->linhas; ++i) {
-        Node* linha_sentinela = this->m_head->abaixo;
-        for (int j = 0; j < i; ++j) {
-            linha_sentinela = linha_sentinela->abaixo;
-        }
-        Node* atual = linha_sentinela->direita;
-        while (atual != linha_sentinela) {
-            Node* temp = atual;
-            atual = atual->direita;
-            delete temp;
-        }
+template <typename T, typename Index>
+void SparseMatrixT<T, Index>::esvaziarListas() {
+    m_pool.liberarTudo();
 
+    for (Index i = 1; i <= this->linhas; ++i) {
+        Node* linha_sentinela = getLinha(i);
         linha_sentinela->direita = linha_sentinela;
     }
+
+    for (Index j = 1; j <= this->colunas; ++j) {
+        Node* coluna_sentinela = getColuna(j);
+        coluna_sentinela->abaixo = coluna_sentinela;
+        m_fim_colunas[j - 1] = coluna_sentinela;
+    }
+    m_colunas_validas = true;
+}
+
+/* Gera uma cópia da matriz na forma comprimida por linhas (CSR)
+ * Se a matriz já estiver congelada, copia a forma CSR existente
+ * Caso contrário, percorre cada linha uma única vez, copiando colunas e valores em sequência
+ */
+template <typename T, typename Index>
+CSRMatrixT<T, Index> SparseMatrixT<T, Index>::toCSR() const {
+    if (isFrozen()) {
+        const CSRView& v = m_vista_csr;
+        CSRMatrix csr;
+        csr.linhas = linhas;
+        csr.colunas = colunas;
+        csr.row_ptr.assign(v.row_ptr, v.row_ptr + linhas + 1);
+        csr.col_idx.assign(v.col_idx, v.col_idx + v.nnz());
+        csr.values.assign(v.values, v.values + v.nnz());
+        return csr;
+    }
+
+    CSRMatrix csr;
+    csr.linhas = linhas;
+    csr.colunas = colunas;
+    csr.row_ptr.reserve(linhas + 1);
+    csr.row_ptr.push_back(0);
+    csr.col_idx.reserve(m_pool.emUso());
+    csr.values.reserve(m_pool.emUso());
+
+    for (Index i = 1; i <= linhas; ++i) {
+        Node* linha_sentinela = getLinha(i);
+        for (Node* elemento = linha_sentinela->direita; elemento != linha_sentinela; elemento = elemento->direita) {
+            csr.col_idx.push_back(elemento->coluna);
+            csr.values.push_back(elemento->valor);
+        }
+        csr.row_ptr.push_back(static_cast<Index>(csr.values.size()));
+    }
+    PERFIL(contarSaltos(static_cast<long long>(m_pool.emUso()) + linhas);)
+    return csr;
+}
+
+/* Congela a matriz para uso somente leitura
+ * Copia os elementos para a forma CSR e, se solicitado, monta também a forma CSC
+ * Libera os nós das listas encadeadas, reduzindo a memória ocupada por elemento
+ * Não faz nada se a matriz já estiver congelada, exceto montar a forma CSC que faltar
+ */
+template <typename T, typename Index>
+void SparseMatrixT<T, Index>::freeze(bool comCSC) {
+    if (!isFrozen()) {
+        m_csr = new CSRMatrix(toCSR());
+        m_vista_csr = *m_csr;
+        esvaziarListas();
+    }
+    if (comCSC && !getCSC()) {
+        m_csc = new CSRMatrix(transpor(m_vista_csr));
+        m_vista_csc = *m_csc;
+    }
+}
+
+/* Dono compartilhado dos vetores das formas de uma matriz congelada e da sua vistaTransposta
+ * Guarda as formas que pertenciam à matriz e o dono anterior (um arquivo mapeado), se houver
+ */
+template <typename T, typename Index>
+struct FormasCompartilhadas {
+    shared_ptr<const void> anterior;
+    unique_ptr<CSRMatrixT<T, Index>> csr, csc;
+};
+
+/* Retorna a transposta da matriz congelada sem copiar os seus vetores
+ * Monta a forma CSC, se faltar, transpondo a forma CSR por contagem
+ * Passa as formas que pertencem à matriz para um dono compartilhado, que também passa a manter vivo o dono anterior
+ * A transposta é construída congelada com as formas trocadas: a CSC desta matriz é a sua CSR, e vice-versa
+ */
+template <typename T, typename Index>
+SparseMatrixT<T, Index> SparseMatrixT<T, Index>::vistaTransposta() {
+    if (!isFrozen()) {
+        throw logic_error("Erro: A matriz precisa estar congelada para ser transposta sem copia.");
+    }
+    freeze(true);
+    if (m_csr || m_csc) {
+        shared_ptr<FormasCompartilhadas<T, Index>> formas = make_shared<FormasCompartilhadas<T, Index>>();
+        formas->anterior = move(m_dono);
+        formas->csr.reset(m_csr);
+        formas->csc.reset(m_csc);
+        m_csr = m_csc = nullptr;
+        m_dono = formas;
+    }
+    return SparseMatrixT(m_vista_csc, m_vista_csr, m_dono);
+}
+
+/* Descongela a matriz, voltando às listas encadeadas
+ * Cria os sentinelas, caso a matriz tenha sido construída já congelada
+ * Reconstrói as listas e as contagens de elementos a partir da forma CSR
+ * Descarta as formas comprimidas ao final
+ */
+template <typename T, typename Index>
+void SparseMatrixT<T, Index>::thaw() {
+    if (!isFrozen()) return;
+
+    CSRMatrix* csr = m_csr;
+    CSRView vista = m_vista_csr;
+    shared_ptr<const void> dono = move(m_dono);
+    m_csr = nullptr;
+    descartarFormas();
+
+    criarSentinelas();
+    zerarContagens();
+    carregarCSR(vista);
+    delete csr;
+}
+
+/* Preenche as listas encadeadas com os elementos de uma matriz CSR de mesmas dimensões
+ * Reconstrói cada linha de uma só vez, de cima para baixo, de modo que cada nó
+ * entre no final da sua coluna em tempo constante
+ */
+template <typename T, typename Index>
+void SparseMatrixT<T, Index>::carregarCSR(const CSRView& csr) {
+    for (Index i = 1; i <= linhas; ++i) {
+        Index inicio = csr.row_ptr[i - 1];
+        inserirLinha(i, csr.col_idx + inicio, csr.values + inicio, csr.row_ptr[i] - inicio);
+    }
 }
 
 /* Imprime a matriz esparsa no formato tradicional, incluindo os zeros
+ * Se a matriz tiver mais posições que LIMITE_IMPRESSAO_DENSA e a impressão não for forçada,
+ * avisa e imprime apenas o resumo, já que a saída cresceria com linhas x colunas
  * Define a largura das colunas para garantir alinhamento na exibição
  * Percorre todas as linhas e colunas, imprimindo os valores existentes
+ * Lê os valores da forma CSR quando a matriz está congelada
  * Exibe 0.0 para posições vazias, mantendo a estrutura da matriz
  * Utiliza bordas para melhorar a visualização no terminal
  */
 
-void SparseMatrix::print() const {
-    int largura_coluna = 6;
-    int largura_total = colunas * largura_coluna + 3;
+template <typename T, typename Index>
+void SparseMatrixT<T, Index>::print(bool forcar) const {
+    if (!forcar && static_cast<long long>(linhas) * colunas > LIMITE_IMPRESSAO_DENSA) {
+        cout << "Matriz grande demais para a impressao densa; exibindo o resumo.\n";
+        printSummary(20);
+        return;
+    }
+
+    Index largura_coluna = 6;
+    Index largura_total = colunas * largura_coluna + 3;
 
     cout << string(largura_total, '-') << "\n";
 
-    for (Node* linha = m_head->abaixo; linha != m_head; linha = linha->abaixo) {
+    for (Index i = 1; i <= linhas; ++i) {
         cout << "|";
-        Node* elemento = linha->direita;
-        for (int j = 1; j <= colunas; ++j) {
-            if (elemento != linha && elemento->coluna == j) {
-                cout << setw(6) << fixed << setprecision(1) << elemento->valor;
-                elemento = elemento->direita;
-            } else {
-                cout << setw(6) << "0.0";
+        if (isFrozen()) {
+            Index k = m_vista_csr.row_ptr[i - 1];
+            for (Index j = 1; j <= colunas; ++j) {
+                if (k < m_vista_csr.row_ptr[i] && m_vista_csr.col_idx[k] == j) {
+                    cout << setw(6) << fixed << setprecision(1) << m_vista_csr.values[k++];
+                } else {
+                    cout << setw(6) << "0.0";
+                }
+            }
+        } else {
+            Node* linha = getLinha(i);
+            Node* elemento = linha->direita;
+            for (Index j = 1; j <= colunas; ++j) {
+                if (elemento != linha && elemento->coluna == j) {
+                    cout << setw(6) << fixed << setprecision(1) << elemento->valor;
+                    elemento = elemento->direita;
+                } else {
+                    cout << setw(6) << "0.0";
+                }
             }
         }
         cout << " |\n";
@@ -199,3 +1032,62 @@ void SparseMatrix::print() const {
 
     cout << string(largura_total, '-') << "\n";
 }
+
+/* Imprime um resumo da matriz, com custo limitado mesmo para matrizes enormes
+ * Exibe as dimensões, a quantidade de elementos não nulos, a densidade e se a matriz está congelada
+ * Percorre as linhas de cima para baixo até exibir maxElementos elementos, no formato (i, j) = valor
+ * Informa quantos elementos não foram exibidos e restaura a formatação de cout
+ */
+template <typename T, typename Index>
+void SparseMatrixT<T, Index>::printSummary(int maxElementos) const {
+    ios::fmtflags formato = cout.flags();
+    streamsize precisao = cout.precision();
+    Index nnz = countNonZero();
+    cout << "Matriz " << linhas << "x" << colunas << ", " << nnz << " elementos nao nulos (densidade "
+         << setprecision(3) << defaultfloat << 100.0 * nnz / (static_cast<double>(linhas) * colunas) << "%)"
+         << (isFrozen() ? ", congelada" : "") << "\n";
+    cout << setprecision(6);
+
+    Index exibidos = 0;
+    for (Index i = 1; i <= linhas && exibidos < maxElementos; ++i) {
+        if (isFrozen()) {
+            for (Index k = m_vista_csr.row_ptr[i - 1]; k < m_vista_csr.row_ptr[i] && exibidos < maxElementos; ++k, ++exibidos) {
+                cout << "(" << i << ", " << m_vista_csr.col_idx[k] << ") = " << m_vista_csr.values[k] << "\n";
+            }
+        } else {
+            Node* linha = getLinha(i);
+            for (Node* elemento = linha->direita; elemento != linha && exibidos < maxElementos; elemento = elemento->direita, ++exibidos) {
+                cout << "(" << i << ", " << elemento->coluna << ") = " << elemento->valor << "\n";
+            }
+        }
+    }
+    if (nnz > exibidos) {
+        cout << "... mais " << nnz - exibidos << " elementos\n";
+    }
+    cout.flags(formato);
+    cout.precision(precisao);
+}
+
+/* Retorna um intervalo com os elementos não nulos da coluna j
+ * Lança uma exceção se o índice da coluna for inválido ou se a matriz estiver congelada
+ * Lança uma exceção também se as colunas estiverem desatualizadas por somarLinha, sem religarColunas;
+ * como a função é constante, ela nunca altera os encadeamentos, e várias threads podem chamá-la ao mesmo tempo
+ * A coluna é percorrida pelos ponteiros "abaixo", em ordem crescente de linha,
+ * com custo proporcional apenas à quantidade de elementos da coluna
+ */
+template <typename T, typename Index>
+typename SparseMatrixT<T, Index>::ColumnRange SparseMatrixT<T, Index>::coluna(Index j) const {
+    if (j < 1 || j > colunas) {
+        throw out_of_range("Erro: Indices fora dos limites da matriz.");
+    }
+    if (isFrozen()) {
+        throw logic_error("Erro: A matriz esta congelada; use a forma CSC.");
+    }
+    if (!m_colunas_validas) {
+        throw logic_error("Erro: As colunas estao desatualizadas; chame religarColunas depois de somarLinha.");
+    }
+    return ColumnRange(getColuna(j));
+}
+
+#define INSTANCIAR(T, Index) template class SparseMatrixT<T, Index>;
+PARA_CADA_TIPO_MATRIZ(INSTANCIAR)
@@ -2,47 +2,272 @@
 #define SPARSE_MATRIX_H
 
 #include "Node.h"
+#include "node_pool.h"
+#include "csr_matrix.h"
+#include "profiling.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Estatísticas da estrutura de uma matriz esparsa, mantidas pela própria matriz à medida que ela muda
+struct EstatisticasMatriz {
+    long long linhas = 0, colunas = 0;
+    long long nnz = 0;       // Elementos não nulos
+    long long maxLinha = 0;  // Maior quantidade de elementos em uma linha
+    long long maxColuna = 0; // Maior quantidade de elementos em uma coluna
+    double mediaLinha = 0;   // Média de elementos por linha
+    long long banda = 0;     // Maior distância |i - j| de um elemento à diagonal
+    double densidade = 0;    // Fração das posições ocupadas
+};
+
+// Definição da classe SparseMatrixT para manipulação de matrizes esparsas
+// Representa uma matriz esparsa usando listas encadeadas circulares, com valores do tipo T e índices do tipo Index
+// (inteiro com sinal: int32_t ou int64_t). As combinações disponíveis estão em matrix_types.h.
+template <typename T, typename Index>
+class SparseMatrixT {
+public:
+    using Node = NodeT<T, Index>;
+    using NodePool = NodePoolT<T, Index>;
+    using CSRMatrix = CSRMatrixT<T, Index>;
+    using CSRView = CSRViewT<T, Index>;
 
-// Definição da classe SparseMatrix para manipulação de matrizes esparsas
-// Representa uma matriz esparsa usando listas encadeadas circulares
-class SparseMatrix {
 private:
-    int linhas, colunas; // Dimensões da matriz
+    Index linhas, colunas; // Dimensões da matriz
     Node* m_head; // Nó sentinela principal
+    Node* m_linhas; // Sentinelas das linhas em bloco contíguo (linha i em m_linhas[i - 1])
+    Node* m_colunas; // Sentinelas das colunas em bloco contíguo (coluna j em m_colunas[j - 1])
+    Node** m_fim_colunas; // Último nó de cada coluna (o próprio sentinela se a coluna estiver vazia)
+    bool m_colunas_validas; // Falso depois de somarLinha, até as listas das colunas serem religadas
+    NodePool m_pool; // Fornece os nós dos elementos não nulos
+    CSRMatrix* m_csr; // Vetores da forma CSR quando pertencem à matriz (senão nullptr)
+    CSRMatrix* m_csc; // Vetores da forma CSC quando pertencem à matriz (senão nullptr)
+    CSRView m_vista_csr; // Forma comprimida por linhas enquanto a matriz está congelada (senão vazia)
+    CSRView m_vista_csc; // Forma comprimida por colunas, opcional enquanto a matriz está congelada
+    std::shared_ptr<const void> m_dono; // Mantém vivos os vetores das formas que não pertencem à matriz
+    mutable std::vector<Index> m_nnz_linhas; // Elementos não nulos de cada linha, válidos se m_contagens_validas
+    mutable std::vector<Index> m_nnz_colunas; // Elementos não nulos de cada coluna (idem)
+    mutable std::atomic<bool> m_contagens_validas; // Falso se a matriz foi construída congelada e as contagens ainda não foram pedidas
+    mutable Index m_banda; // Maior |i - j| entre os elementos, válida se m_banda_valida
+    mutable std::atomic<bool> m_banda_valida; // Falso depois que um elemento na borda da banda foi removido
+    mutable std::mutex m_trava_calculo; // Serializa o cálculo tardio das contagens e da banda pelas funções constantes
+#ifdef SPARSE_PROFILING
+    mutable PerfilMatriz m_perfil; // Contadores de percurso, só com a instrumentação ligada
+#endif
 
     // Libera a memória alocada pela matriz
     void desalocar();
 
+    // Aloca e encadeia os sentinelas das linhas e das colunas, se ainda não existirem
+    void criarSentinelas();
+
+    // Descarta as formas comprimidas e o dono dos seus vetores
+    void descartarFormas();
+
+    // Libera todos os nós e deixa as listas de linhas e colunas vazias
+    void esvaziarListas();
+
+    // Preenche as listas encadeadas, que devem estar vazias, com os elementos de uma matriz CSR
+    void carregarCSR(const CSRView& csr);
+
+    // Intercala uma linha ordenada na linha i, somando os elementos de mesma coluna, sem religar as colunas
+    // Retorna verdadeiro se algum nó foi criado ou removido
+    bool mesclarLinha(Index i, const Index* cols, const T* valores, Index n);
+
+    // Encadeia um nó recém-criado na lista da sua coluna, mantendo a ordem das linhas
+    void ligarNaColuna(Node* novo);
+
+    // Conta um elemento criado em (i, j) nas contagens da linha e da coluna e na banda
+    void contarElemento(Index i, Index j);
+
+    // Desconta um elemento removido de (i, j)
+    void descontarElemento(Index i, Index j);
+
+    // Zera as contagens de todas as linhas e colunas e a banda
+    void zerarContagens();
+
+    // Calcula as contagens a partir da forma CSR, se ainda não forem válidas; seguro entre leitores simultâneos
+    void calcularContagens() const;
+
+    // Recalcula a banda, se ainda não for válida, e a retorna; seguro entre leitores simultâneos
+    Index calcularBanda() const;
+
 public:
+    // Iterador que percorre os elementos não nulos de uma coluna, de cima para baixo
+    class ColumnIterator {
+    private:
+        const Node* atual;
+
+    public:
+        explicit ColumnIterator(const Node* no) : atual(no) {}
+        const Node& operator*() const { return *atual; }
+        const Node* operator->() const { return atual; }
+        ColumnIterator& operator++() { atual = atual->abaixo; return *this; }
+        bool operator!=(const ColumnIterator& outro) const { return atual != outro.atual; }
+        bool operator==(const ColumnIterator& outro) const { return atual == outro.atual; }
+    };
+
+    // Intervalo de uma coluna, utilizável em laços "for (const Node& no : m.coluna(j))"
+    class ColumnRange {
+    private:
+        const Node* sentinela;
+
+    public:
+        explicit ColumnRange(const Node* s) : sentinela(s) {}
+        ColumnIterator begin() const { return ColumnIterator(sentinela->abaixo); }
+        ColumnIterator end() const { return ColumnIterator(sentinela); }
+    };
+
     // Construtor da classe
-    SparseMatrix(int m, int n);
+    SparseMatrixT(Index m, Index n);
+
+    // Constrói a matriz, já descongelada, com os elementos de uma matriz CSR
+    explicit SparseMatrixT(const CSRView& csr);
+
+    // Constrói a matriz já congelada sobre vetores CSR (e, opcionalmente, CSC) que não pertencem a ela, sem copiá-los
+    // "dono" mantém esses vetores vivos (por exemplo, um arquivo mapeado na memória) enquanto a matriz os usar
+    SparseMatrixT(const CSRView& csr, const CSRView& csc, std::shared_ptr<const void> dono);
+
+    // Constrói uma cópia independente de outra matriz, linha a linha
+    // Uma matriz congelada sobre vetores de outro dono (um arquivo mapeado) compartilha esses vetores, sem copiá-los;
+    // as formas que pertencem à própria matriz (a CSC montada depois por freeze(true)) são copiadas
+    SparseMatrixT(const SparseMatrixT& outra);
+
+    // Toma para si os nós, os sentinelas e as formas de outra matriz, em tempo constante
+    // A matriz de origem fica vazia e só pode ser destruída ou receber outra matriz por atribuição
+    SparseMatrixT(SparseMatrixT&& outra) noexcept;
+
+    // Atribuição por cópia ou por movimento (a cópia, se houver, é feita no parâmetro)
+    SparseMatrixT& operator=(SparseMatrixT outra) noexcept;
+
+    // Troca o conteúdo desta matriz pelo de outra, em tempo constante
+    void trocar(SparseMatrixT& outra) noexcept;
 
     // Destrutor da classe
-    ~SparseMatrix();
+    ~SparseMatrixT();
+
+    // Insere ou atualiza um valor na matriz; o valor 0 remove o elemento (i, j), se existir
+    void inserir(Index i, Index j, T value);
+
+    // Remove o elemento (i, j), desligando-o da linha e da coluna; não faz nada se a posição estiver vazia
+    void remover(Index i, Index j);
 
-    // Insere ou atualiza um valor na matriz
-    void inserir(int i, int j, double value);
+    // Remove, em uma única passada, todos os elementos com valor absoluto até epsilon; retorna quantos removeu
+    Index prune(double epsilon);
+
+    // Preenche a linha i, que deve estar vazia, com n colunas em ordem estritamente crescente
+    void inserirLinha(Index i, const Index* cols, const T* valores, Index n);
+
+    // Preenche a linha i, que deve estar vazia, com colunas em ordem estritamente crescente
+    void inserirLinha(Index i, const std::vector<Index>& cols, const std::vector<T>& valores);
+
+    // Soma alpha * B a esta matriz, sem alocar uma terceira matriz (A += alpha * B)
+    void axpy(T alpha, const SparseMatrixT& B);
+
+    // Soma à linha i, no próprio lugar, n elementos com colunas em ordem estritamente crescente
+    // Não atualiza as listas das colunas: depois de somar as linhas, chame religarColunas antes de percorrê-las
+    void somarLinha(Index i, const Index* cols, const T* valores, Index n);
+
+    // Reconstrói os encadeamentos de todas as colunas a partir das linhas, em uma única passada,
+    // se somarLinha os deixou desatualizados
+    void religarColunas();
+
+    // Soma B a esta matriz (A += B)
+    SparseMatrixT& operator+=(const SparseMatrixT& B) { axpy(T(1), B); return *this; }
 
     // Retorna o valor armazenado em (i, j), ou 0 se não existir
-    double get(int i, int j) const;
+    T get(Index i, Index j) const;
+
+    // Retorna a quantidade de elementos não nulos da matriz, em tempo constante
+    Index countNonZero() const;
 
-    // Conta os elementos não nulos da matriz
-    int countNonZero() const;
+    // Retorna a quantidade de elementos não nulos da linha i, em tempo constante
+    Index countNonZeroRow(Index i) const;
+
+    // Retorna a quantidade de elementos não nulos da coluna j, em tempo constante
+    Index countNonZeroColumn(Index j) const;
+
+    // Retorna as estatísticas da estrutura da matriz, sem percorrer os elementos
+    // (exceto para recalcular a banda depois que um elemento na sua borda foi removido)
+    EstatisticasMatriz getEstatisticas() const;
 
     // Remove todos os elementos não nulos da matriz
     void clear();
 
+    // Quantidade máxima de posições (linhas x colunas) impressas por print sem ser forçado
+    static constexpr long long LIMITE_IMPRESSAO_DENSA = 10000;
+
     // Imprime a matriz completa, incluindo os zeros
-    void print() const;
+    // Acima de LIMITE_IMPRESSAO_DENSA posições, imprime apenas o resumo, a menos que "forcar" seja verdadeiro
+    void print(bool forcar = false) const;
+
+    // Imprime as dimensões, a quantidade de elementos não nulos e os primeiros maxElementos elementos
+    void printSummary(int maxElementos) const;
+
+    // Retorna os elementos não nulos da coluna j
+    ColumnRange coluna(Index j) const;
+
+    // Congela a matriz: troca as listas encadeadas pela forma CSR (e, opcionalmente, CSC)
+    void freeze(bool comCSC = false);
+
+    // Descongela a matriz, reconstruindo as listas encadeadas a partir da forma CSR
+    void thaw();
+
+    // Indica se a matriz está congelada
+    bool isFrozen() const { return m_vista_csr.row_ptr != nullptr; }
+
+    // Retorna a forma CSR da matriz congelada, ou nullptr se ela não estiver congelada
+    const CSRView* getCSR() const { return isFrozen() ? &m_vista_csr : nullptr; }
+
+    // Retorna a forma CSC da matriz congelada, ou nullptr se ela não tiver sido construída
+    const CSRView* getCSC() const { return m_vista_csc.row_ptr ? &m_vista_csc : nullptr; }
+
+    // Retorna a transposta desta matriz, já congelada, sobre os mesmos vetores CSR e CSC, sem copiar nenhum elemento
+    // A matriz deve estar congelada; se ainda não tiver a forma CSC, ela é montada antes, por contagem
+    // Os vetores das formas passam a ter um dono compartilhado, e as duas matrizes podem ser destruídas em qualquer ordem
+    SparseMatrixT vistaTransposta();
+
+    // Gera uma cópia da matriz na forma CSR, esteja ela congelada ou não
+    CSRMatrix toCSR() const;
+
+    // Retorna os contadores de alocação dos nós da matriz
+    const ContadoresAlocacao& getContadoresAlocacao() const { return m_pool.getContadores(); }
+
+    // Retorna os contadores de percurso da matriz (todos em zero sem -DSPARSE_PROFILING)
+#ifdef SPARSE_PROFILING
+    ContadoresPercurso getContadoresPercurso() const { return m_perfil.ler(); }
+#else
+    ContadoresPercurso getContadoresPercurso() const { return ContadoresPercurso(); }
+#endif
+
+    // Registra n saltos feitos por uma operação externa ao percorrer as listas da matriz
+    void contarSaltos(long long n) const { PERFIL(PerfilMatriz::somar(m_perfil.saltos, n);) (void)n; }
+
+    // Retorna a quantidade de bytes que a matriz mantém alocados: nós, sentinelas, contagens e formas comprimidas
+    // Os vetores de um arquivo mapeado ou compartilhados com uma vistaTransposta não pertencem à matriz e não são contados
+    std::size_t bytesResidentes() const;
 
     // Retorna o número de linhas da matriz
-    int getLinhas() const { return linhas; }
+    Index getLinhas() const { return linhas; }
     
     // Retorna o número de colunas da matriz
-    int getColunas() const { return colunas; }
+    Index getColunas() const { return colunas; }
     
+    // Os sentinelas abaixo só dão acesso aos elementos enquanto a matriz não está congelada
+
     // Retorna o nó sentinela principal da matriz
     Node* getHead() const { return m_head; }
+
+    // Retorna o nó sentinela da linha i (1 <= i <= linhas) em tempo constante
+    Node* getLinha(Index i) const { return m_linhas + (i - 1); }
+
+    // Retorna o nó sentinela da coluna j (1 <= j <= colunas) em tempo constante
+    // Após somarLinha, a lista da coluna só volta a ser confiável depois de uma chamada a religarColunas
+    Node* getColuna(Index j) const { return m_colunas + (j - 1); }
 };
 
+// Matriz usada pelo programa: valores double e índices int
+using SparseMatrix = SparseMatrixT<double, int>;
+
 #endif
\ No newline at end of file
@@ -0,0 +1,968 @@
+#include "sparse_ops.h"
+#include "bsr_matrix.h"
+#include "thread_pool.h"
+#include "binary_format.h"
+#include "matrix_io.h"
+#include "matrix_types.h"
+#include <algorithm>
+#include <climits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__AVX512F__) || (defined(__AVX2__) && defined(__FMA__))
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// Pool de threads usado pelas operações; nulo quando elas rodam em uma única thread
+static unique_ptr<ThreadPool> poolOperacoes;
+
+// Quantidade de blocos de linhas por thread nas versões paralelas; sobra trabalho para ser roubado
+static const int BLOCOS_POR_THREAD = 8;
+
+// Trabalho mínimo (elementos somados ou produtos calculados) para sum, multiply e spmvCSR usarem o pool de threads;
+// abaixo dele, o custo de distribuir os blocos supera o ganho
+static const long long TRABALHO_MINIMO_PARALELO = 1 << 16;
+
+// Memória reservada em multiplyStreaming para os buffers dos arquivos e outros gastos fixos
+static const size_t MEMORIA_FIXA_STREAMING = 256 * 1024;
+
+// Memória usada por elemento em multiplyStreaming: bloco de A (row_ptr, coluna e valor) e bloco de C (coluna e valor)
+static const size_t BYTES_POR_ELEMENTO_STREAMING = 2 * sizeof(int) + sizeof(double) + sizeof(int) + sizeof(double);
+
+/* Define quantas threads as operações devem usar
+ * Com n <= 1, descarta o pool e as operações voltam a rodar na thread atual
+ */
+void setNumThreads(int n) {
+    if(n <= 1) {
+        poolOperacoes.reset();
+    } else if(!poolOperacoes || poolOperacoes->tamanho() != n) {
+        poolOperacoes.reset(new ThreadPool(n));
+    }
+}
+
+// Retorna quantas threads as operações usam
+int getNumThreads() {
+    return poolOperacoes ? poolOperacoes->tamanho() : 1;
+}
+
+/* Copia as colunas e os valores da linha i de uma matriz, congelada ou não
+ * Só lê a estrutura, por isso pode ser chamada por várias threads ao mesmo tempo
+ */
+template <typename T, typename Index>
+static void copiarLinha(const SparseMatrixT<T, Index>* M, Index i, vector<Index>& cols, vector<T>& valores) {
+    cols.clear();
+    valores.clear();
+    if(M->isFrozen()) {
+        const CSRViewT<T, Index>& csr = *M->getCSR();
+        cols.assign(csr.col_idx + csr.row_ptr[i - 1], csr.col_idx + csr.row_ptr[i]);
+        valores.assign(csr.values + csr.row_ptr[i - 1], csr.values + csr.row_ptr[i]);
+    } else {
+        NodeT<T, Index>* linha = M->getLinha(i);
+        for(NodeT<T, Index>* elemento = linha->direita; elemento != linha; elemento = elemento->direita) {
+            cols.push_back(elemento->coluna);
+            valores.push_back(elemento->valor);
+        }
+        PERFIL(M->contarSaltos(static_cast<long long>(cols.size()) + 1);)
+    }
+}
+
+/* Intercala duas linhas ordenadas, somando os elementos de mesma coluna
+ * Acrescenta o resultado ao final de cols/valores, descartando as somas nulas
+ */
+template <typename T, typename Index>
+static void intercalarLinhas(const Index* colsA, const T* valA, Index nA,
+                             const Index* colsB, const T* valB, Index nB,
+                             vector<Index>& cols, vector<T>& valores) {
+    Index a = 0, b = 0;
+    while(a < nA || b < nB) {
+        Index j;
+        T valor;
+        if(b == nB || (a < nA && colsA[a] < colsB[b])) {
+            j = colsA[a];
+            valor = valA[a++];
+        } else if(a == nA || colsB[b] < colsA[a]) {
+            j = colsB[b];
+            valor = valB[b++];
+        } else {
+            j = colsA[a];
+            valor = valA[a++] + valB[b++];
+        }
+        if(valor != T()) {
+            cols.push_back(j);
+            valores.push_back(valor);
+        }
+    }
+}
+
+/* Calcula uma linha do produto A * B pelo algoritmo de Gustavson
+ * Recebe a linha de A (colunas e valores) e acrescenta a linha do produto ao final de cols/valores
+ * Fase simbólica: marca as colunas alcançadas, obtendo o tamanho e a ordem da linha do produto
+ * Fase numérica: acumula os produtos em um vetor denso indexado pela coluna
+ * O acumulador deve estar zerado e o marcador não pode conter o valor "marca" na entrada;
+ * o acumulador volta zerado ao final
+ */
+template <typename T, typename Index>
+static void multiplicarLinha(const Index* colsA, const T* valA, Index nA, const CSRViewT<T, Index>& B,
+                             vector<T>& acumulador, vector<Index>& marcador, Index marca,
+                             vector<Index>& cols, vector<T>& valores) {
+    size_t inicio = cols.size();
+    for(Index a = 0; a < nA; ++a) {
+        Index k = colsA[a];
+        for(Index b = B.row_ptr[k - 1]; b < B.row_ptr[k]; ++b) {
+            Index j = B.col_idx[b];
+            if(marcador[j] != marca) {
+                marcador[j] = marca;
+                cols.push_back(j);
+            }
+        }
+    }
+    if(cols.size() == inicio) return;
+    sort(cols.begin() + inicio, cols.end());
+
+    for(Index a = 0; a < nA; ++a) {
+        Index k = colsA[a];
+        T valorA = valA[a];
+        for(Index b = B.row_ptr[k - 1]; b < B.row_ptr[k]; ++b) {
+            acumulador[B.col_idx[b]] += valorA * B.values[b];
+        }
+    }
+
+    size_t n = inicio;
+    for(size_t k = inicio; k < cols.size(); ++k) {
+        Index j = cols[k];
+        if(acumulador[j] != T()) {
+            cols[n++] = j;
+            valores.push_back(acumulador[j]);
+        }
+        acumulador[j] = T();
+    }
+    cols.resize(n);
+}
+
+/* Divide as linhas 1..m em blocos contíguos de custo parecido
+ * Recebe o custo acumulado das linhas (custo[i] = custo das linhas 1..i) e retorna
+ * as fronteiras dos blocos: o bloco b cobre as linhas [fronteiras[b], fronteiras[b + 1])
+ */
+template <typename Index>
+static vector<Index> dividirPorCusto(const vector<long long>& custo, int blocos) {
+    Index m = static_cast<Index>(custo.size()) - 1;
+    vector<Index> fronteiras(1, 1);
+    for(int b = 1; b < blocos; ++b) {
+        long long alvo = custo[m] * b / blocos;
+        Index linha = static_cast<Index>(lower_bound(custo.begin() + fronteiras.back(), custo.end(), alvo) - custo.begin());
+        fronteiras.push_back(max(fronteiras.back(), min(linha, m + 1)));
+    }
+    fronteiras.push_back(m + 1);
+    return fronteiras;
+}
+
+/* Une na matriz C as linhas calculadas em paralelo
+ * Cada bloco guarda suas linhas na forma CSR, com row_ptr relativo ao início do bloco
+ * As linhas são ligadas em ordem, de cima para baixo, pela thread que chamou a operação;
+ * como cada bloco foi escrito por uma única thread, nenhuma trava é necessária
+ */
+template <typename T, typename Index>
+static void juntarBlocos(SparseMatrixT<T, Index>* C, const vector<Index>& fronteiras, const vector<CSRMatrixT<T, Index>>& blocos) {
+    for(size_t b = 0; b < blocos.size(); ++b) {
+        const CSRMatrixT<T, Index>& bloco = blocos[b];
+        for(Index i = fronteiras[b]; i < fronteiras[b + 1]; ++i) {
+            Index k = i - fronteiras[b];
+            Index inicio = bloco.row_ptr[k];
+            C->inserirLinha(i, bloco.col_idx.data() + inicio, bloco.values.data() + inicio, bloco.row_ptr[k + 1] - inicio);
+        }
+    }
+}
+
+/* Soma duas matrizes dividindo as linhas entre as threads do pool
+ * Cada bloco de linhas é intercalado por uma única thread em vetores próprios, reservados
+ * de antemão pelas contagens de elementos das linhas de A e de B
+ * Os blocos têm o mesmo número de linhas; linhas mais pesadas são compensadas
+ * pelo roubo de blocos entre as threads
+ */
+template <typename T, typename Index>
+static SparseMatrixT<T, Index>* sumParalelo(const SparseMatrixT<T, Index>* A, const SparseMatrixT<T, Index>* B, ThreadPool& pool) {
+    Index m = A->getLinhas();
+    int nBlocos = static_cast<int>(min<Index>(m, pool.tamanho() * BLOCOS_POR_THREAD));
+    vector<Index> fronteiras(nBlocos + 1);
+    for(int b = 0; b <= nBlocos; ++b) {
+        fronteiras[b] = 1 + static_cast<Index>(static_cast<long long>(m) * b / nBlocos);
+    }
+
+    vector<CSRMatrixT<T, Index>> blocos(nBlocos);
+    pool.executar(nBlocos, [&](int b, int) {
+        vector<Index> colsA, colsB;
+        vector<T> valA, valB;
+        CSRMatrixT<T, Index>& bloco = blocos[b];
+        size_t maximo = 0;
+        for(Index i = fronteiras[b]; i < fronteiras[b + 1]; ++i) {
+            maximo += A->countNonZeroRow(i) + B->countNonZeroRow(i);
+        }
+        bloco.row_ptr.reserve(fronteiras[b + 1] - fronteiras[b] + 1);
+        bloco.col_idx.reserve(maximo);
+        bloco.values.reserve(maximo);
+        bloco.row_ptr.push_back(0);
+        for(Index i = fronteiras[b]; i < fronteiras[b + 1]; ++i) {
+            copiarLinha(A, i, colsA, valA);
+            copiarLinha(B, i, colsB, valB);
+            intercalarLinhas(colsA.data(), valA.data(), static_cast<Index>(colsA.size()),
+                             colsB.data(), valB.data(), static_cast<Index>(colsB.size()),
+                             bloco.col_idx, bloco.values);
+            bloco.row_ptr.push_back(bloco.nnz());
+        }
+    });
+
+    SparseMatrixT<T, Index>* C = new SparseMatrixT<T, Index>(m, A->getColunas());
+    juntarBlocos(C, fronteiras, blocos);
+    return C;
+}
+
+/* Multiplica duas matrizes dividindo as linhas de A entre as threads do pool
+ * Estima o custo de cada linha de A pelo número de produtos que ela gera, em paralelo
+ * Divide as linhas em blocos de custo parecido; blocos que ainda sobrarem são roubados
+ * por threads ociosas
+ * Cada thread usa o próprio acumulador denso e escreve as linhas do seu bloco em vetores próprios
+ */
+template <typename T, typename Index>
+static SparseMatrixT<T, Index>* multiplyParalelo(const SparseMatrixT<T, Index>* A, const CSRViewT<T, Index>& B, ThreadPool& pool) {
+    Index m = A->getLinhas();
+    int nBlocos = static_cast<int>(min<Index>(m, pool.tamanho() * BLOCOS_POR_THREAD));
+
+    vector<long long> custo(m + 1, 0);
+    pool.executar(nBlocos, [&](int b, int) {
+        vector<Index> cols;
+        vector<T> valores;
+        Index fim = 1 + static_cast<Index>(static_cast<long long>(m) * (b + 1) / nBlocos);
+        for(Index i = 1 + static_cast<Index>(static_cast<long long>(m) * b / nBlocos); i < fim; ++i) {
+            copiarLinha(A, i, cols, valores);
+            long long produtos = 1;
+            for(Index k : cols) {
+                produtos += B.row_ptr[k] - B.row_ptr[k - 1];
+            }
+            custo[i] = produtos;
+        }
+    });
+    for(Index i = 1; i <= m; ++i) {
+        custo[i] += custo[i - 1];
+    }
+    vector<Index> fronteiras = dividirPorCusto<Index>(custo, nBlocos);
+
+    vector<vector<T>> acumuladores(pool.tamanho(), vector<T>(B.colunas + 1, T()));
+    vector<vector<Index>> marcadores(pool.tamanho(), vector<Index>(B.colunas + 1, 0));
+    vector<CSRMatrixT<T, Index>> blocos(nBlocos);
+    pool.executar(nBlocos, [&](int b, int trabalhador) {
+        vector<Index> colsA;
+        vector<T> valA;
+        CSRMatrixT<T, Index>& bloco = blocos[b];
+        bloco.row_ptr.push_back(0);
+        for(Index i = fronteiras[b]; i < fronteiras[b + 1]; ++i) {
+            copiarLinha(A, i, colsA, valA);
+            multiplicarLinha(colsA.data(), valA.data(), static_cast<Index>(colsA.size()), B,
+                             acumuladores[trabalhador], marcadores[trabalhador], i,
+                             bloco.col_idx, bloco.values);
+            bloco.row_ptr.push_back(bloco.nnz());
+        }
+    });
+
+    SparseMatrixT<T, Index>* C = new SparseMatrixT<T, Index>(m, B.colunas);
+    juntarBlocos(C, fronteiras, blocos);
+    return C;
+}
+
+/* Soma duas matrizes na forma CSR e retorna uma nova matriz com o resultado
+ * Intercala as colunas ordenadas de cada linha de A e de B, somando as que coincidem
+ * Descarta as somas nulas e preenche cada linha do resultado de uma só vez
+ */
+template <typename T, typename Index>
+SparseMatrixT<T, Index>* sumCSR(const CSRViewT<T, Index>& A, const CSRViewT<T, Index>& B) {
+    SparseMatrixT<T, Index>* C = new SparseMatrixT<T, Index>(A.linhas, A.colunas);
+
+    vector<Index> cols;
+    vector<T> valores;
+    for(Index i = 1; i <= A.linhas; ++i) {
+        cols.clear();
+        valores.clear();
+        Index a = A.row_ptr[i - 1], b = B.row_ptr[i - 1];
+        intercalarLinhas(A.col_idx + a, A.values + a, A.row_ptr[i] - a,
+                         B.col_idx + b, B.values + b, B.row_ptr[i] - b,
+                         cols, valores);
+        C->inserirLinha(i, cols, valores);
+    }
+
+    return C;
+}
+
+/* Soma duas matrizes esparsas e retorna uma nova matriz com o resultado
+ * Verifica se as dimensões das matrizes são compatíveis, lançando uma exceção se não forem
+ * Com mais de uma thread configurada, divide as linhas entre as threads do pool, se as matrizes
+ * tiverem elementos suficientes para compensar (a contagem é mantida pelas matrizes, sem custo)
+ * Se alguma das matrizes estiver congelada, soma as formas CSR
+ * Caso contrário, percorre as linhas de A e de B lado a lado, com um ponteiro em cada uma,
+ * somando os elementos de mesma coluna e copiando os demais
+ * Descarta as somas nulas e preenche cada linha do resultado de uma só vez
+ * O custo total é proporcional à soma dos elementos não nulos de A e de B
+ */
+template <typename T, typename Index>
+SparseMatrixT<T, Index>* sum(const SparseMatrixT<T, Index>* A, const SparseMatrixT<T, Index>* B) {
+    if(A->getLinhas() != B->getLinhas() || A->getColunas() != B->getColunas()) {
+        throw runtime_error("As matrizes tem dimensoes incompativeis para soma.");
+    }
+
+    if(poolOperacoes && static_cast<long long>(A->countNonZero()) + B->countNonZero() >= TRABALHO_MINIMO_PARALELO) {
+        return sumParalelo(A, B, *poolOperacoes);
+    }
+
+    if(A->isFrozen() || B->isFrozen()) {
+        CSRMatrixT<T, Index> copiaA, copiaB;
+        CSRViewT<T, Index> csrA = A->isFrozen() ? *A->getCSR() : CSRViewT<T, Index>(copiaA = A->toCSR());
+        CSRViewT<T, Index> csrB = B->isFrozen() ? *B->getCSR() : CSRViewT<T, Index>(copiaB = B->toCSR());
+        return sumCSR(csrA, csrB);
+    }
+
+    SparseMatrixT<T, Index>* C = new SparseMatrixT<T, Index>(A->getLinhas(), A->getColunas());
+    PERFIL(A->contarSaltos(static_cast<long long>(A->countNonZero()) + A->getLinhas());
+           B->contarSaltos(static_cast<long long>(B->countNonZero()) + B->getLinhas());)
+
+    vector<Index> cols;
+    vector<T> valores;
+    for(Index i = 1; i <= A->getLinhas(); ++i) {
+        cols.clear();
+        valores.clear();
+
+        NodeT<T, Index>* linhaA = A->getLinha(i);
+        NodeT<T, Index>* linhaB = B->getLinha(i);
+        NodeT<T, Index>* elementoA = linhaA->direita;
+        NodeT<T, Index>* elementoB = linhaB->direita;
+        while(elementoA != linhaA || elementoB != linhaB) {
+            Index j;
+            T valor;
+            if(elementoB == linhaB || (elementoA != linhaA && elementoA->coluna < elementoB->coluna)) {
+                j = elementoA->coluna;
+                valor = elementoA->valor;
+                elementoA = elementoA->direita;
+            } else if(elementoA == linhaA || elementoB->coluna < elementoA->coluna) {
+                j = elementoB->coluna;
+                valor = elementoB->valor;
+                elementoB = elementoB->direita;
+            } else {
+                j = elementoA->coluna;
+                valor = elementoA->valor + elementoB->valor;
+                elementoA = elementoA->direita;
+                elementoB = elementoB->direita;
+            }
+            if(valor != T()) {
+                cols.push_back(j);
+                valores.push_back(valor);
+            }
+        }
+        C->inserirLinha(i, cols, valores);
+    }
+
+    return C;
+}
+
+/* Multiplica duas matrizes na forma CSR pelo algoritmo de Gustavson e retorna uma nova matriz com o resultado.
+ * Calcula C linha a linha: a linha i de C combina as linhas de B indicadas pelas colunas da linha i de A.
+ * Cada linha de C é preenchida de uma só vez, em ordem crescente de coluna, sem zeros.
+ * O custo é proporcional ao número de produtos, mais a ordenação das colunas de cada linha.
+ */
+template <typename T, typename Index>
+SparseMatrixT<T, Index>* multiplyCSR(const CSRViewT<T, Index>& A, const CSRViewT<T, Index>& B) {
+    SparseMatrixT<T, Index>* C = new SparseMatrixT<T, Index>(A.linhas, B.colunas);
+
+    vector<T> acumulador(B.colunas + 1, T());
+    vector<Index> marcador(B.colunas + 1, 0);
+    vector<Index> cols;
+    vector<T> valores;
+
+    for(Index i = 1; i <= A.linhas; ++i) {
+        cols.clear();
+        valores.clear();
+        Index a = A.row_ptr[i - 1];
+        multiplicarLinha(A.col_idx + a, A.values + a, A.row_ptr[i] - a, B,
+                         acumulador, marcador, i, cols, valores);
+        C->inserirLinha(i, cols, valores);
+    }
+
+    return C;
+}
+
+/* Conta os produtos escalares que o algoritmo de Gustavson calcula em A * B.
+ * Cada elemento da coluna k de A é multiplicado por todos os elementos da linha k de B,
+ * de modo que o total é a soma, em k, das contagens da coluna k de A e da linha k de B.
+ */
+template <typename T, typename Index>
+static long long contarProdutos(const SparseMatrixT<T, Index>* A, const SparseMatrixT<T, Index>* B) {
+    long long produtos = 0;
+    for(Index k = 1; k <= A->getColunas(); ++k) {
+        produtos += static_cast<long long>(A->countNonZeroColumn(k)) * B->countNonZeroRow(k);
+    }
+    return produtos;
+}
+
+/* Multiplica duas matrizes esparsas e retorna uma nova matriz com o resultado.
+ * Verifica se as dimensões das matrizes são compatíveis para multiplicação, lançando uma exceção se não forem.
+ * Usa as formas CSR das matrizes congeladas; as demais são copiadas para a forma CSR,
+ * o que custa um percurso linear e dá ao algoritmo acesso contíguo às linhas de B.
+ * Com mais de uma thread configurada, divide as linhas de A entre as threads do pool, se o número de produtos
+ * compensar; ele é obtido das contagens por coluna de A e por linha de B, sem percorrer os elementos.
+ * Em uma thread, se uma amostra das duas matrizes mostra blocos densos (escolherBloco)
+ * e se a contagem dos blocos nas matrizes inteiras (calcularPreenchimento) confirma que os de A e os de B estão
+ * pelo menos PREENCHIMENTO_MINIMO_BSR cheios, converte-as para a forma BSR e multiplica bloco a bloco com o
+ * núcleo vetorizado; senão, usa o produto elemento a elemento, sem alocar nenhum bloco.
+ * Retorna a matriz resultante da multiplicação.
+ */
+template <typename T, typename Index>
+SparseMatrixT<T, Index>* multiply(const SparseMatrixT<T, Index>* A, const SparseMatrixT<T, Index>* B) {
+    if(A->getColunas() != B->getLinhas()) {
+        throw runtime_error("As matrizes tem dimensoes incompativeis para multiplicacao.");
+    }
+
+    CSRMatrixT<T, Index> copiaA, copiaB;
+    CSRViewT<T, Index> csrB = B->isFrozen() ? *B->getCSR() : CSRViewT<T, Index>(copiaB = B->toCSR());
+    if(poolOperacoes && contarProdutos(A, B) >= TRABALHO_MINIMO_PARALELO) {
+        return multiplyParalelo(A, csrB, *poolOperacoes);
+    }
+    CSRViewT<T, Index> csrA = A->isFrozen() ? *A->getCSR() : CSRViewT<T, Index>(copiaA = A->toCSR());
+    Index bloco = escolherBloco(csrA, csrB);
+    if(bloco && calcularPreenchimento(csrA, bloco) >= PREENCHIMENTO_MINIMO_BSR &&
+       calcularPreenchimento(csrB, bloco) >= PREENCHIMENTO_MINIMO_BSR) {
+        return new SparseMatrixT<T, Index>(toCSR(multiplyBSR(toBSR(csrA, bloco, bloco), toBSR(csrB, bloco, bloco))));
+    }
+    return multiplyCSR(csrA, csrB);
+}
+
+/* Soma duas matrizes e retorna o resultado por valor
+ * A matriz alocada por sum é movida para o retorno em tempo constante e a casca vazia é liberada
+ */
+template <typename T, typename Index>
+SparseMatrixT<T, Index> operator+(const SparseMatrixT<T, Index>& A, const SparseMatrixT<T, Index>& B) {
+    unique_ptr<SparseMatrixT<T, Index>> C(sum(&A, &B));
+    return move(*C);
+}
+
+/* Soma B a uma matriz temporária e a retorna, reaproveitando os nós que ela já possui
+ * Encadeamentos como A + B + C alocam uma única matriz para o resultado
+ */
+template <typename T, typename Index>
+SparseMatrixT<T, Index> operator+(SparseMatrixT<T, Index>&& A, const SparseMatrixT<T, Index>& B) {
+    A += B;
+    return move(A);
+}
+
+// A soma é comutativa: acumula A na matriz temporária B
+template <typename T, typename Index>
+SparseMatrixT<T, Index> operator+(const SparseMatrixT<T, Index>& A, SparseMatrixT<T, Index>&& B) {
+    B += A;
+    return move(B);
+}
+
+// Com os dois operandos temporários, reaproveita o primeiro
+template <typename T, typename Index>
+SparseMatrixT<T, Index> operator+(SparseMatrixT<T, Index>&& A, SparseMatrixT<T, Index>&& B) {
+    A += B;
+    return move(A);
+}
+
+/* Multiplica duas matrizes e retorna o resultado por valor
+ * O produto não pode ser calculado sobre um dos operandos, pois as suas linhas são lidas até o fim
+ */
+template <typename T, typename Index>
+SparseMatrixT<T, Index> operator*(const SparseMatrixT<T, Index>& A, const SparseMatrixT<T, Index>& B) {
+    unique_ptr<SparseMatrixT<T, Index>> C(multiply(&A, &B));
+    return move(*C);
+}
+
+/* Multiplica duas matrizes gravadas no formato binário, gravando o resultado em outro arquivo.
+ * Abre B mapeada na memória, já congelada, e desconta do orçamento o tamanho do seu arquivo, o acumulador,
+ * o marcador e a linha em cálculo; o restante define quantos elementos cabem em um bloco de A e em um bloco de C.
+ * Lança uma exceção se o orçamento não comportar nem isso ou se as dimensões forem incompatíveis.
+ * Lê A bloco a bloco e calcula cada linha de C pelo algoritmo de Gustavson, passando-a ao escritor,
+ * que grava os elementos acumulados sempre que o seu bloco enche.
+ * Retorna a quantidade de elementos não nulos de C.
+ */
+long long multiplyStreaming(const string& arquivoA, const string& arquivoB, const string& arquivoC, size_t memoriaMaxima) {
+    unique_ptr<SparseMatrix> B(openBinary(arquivoB));
+    const CSRView& csrB = *B->getCSR();
+    int n = csrB.colunas;
+
+    size_t fixa = LayoutBinario(csrB.linhas, csrB.nnz()).tamanho + MEMORIA_FIXA_STREAMING +
+                  static_cast<size_t>(n + 1) * (sizeof(double) + sizeof(int)) + static_cast<size_t>(n) * (sizeof(int) + sizeof(double));
+    if(memoriaMaxima < fixa + BYTES_POR_ELEMENTO_STREAMING) {
+        throw runtime_error("Erro: Memoria insuficiente para o produto em blocos.");
+    }
+    int capacidade = static_cast<int>(min<size_t>((memoriaMaxima - fixa) / BYTES_POR_ELEMENTO_STREAMING, INT_MAX - 1));
+
+    LeitorBinario leitorA(arquivoA, capacidade);
+    if(leitorA.getColunas() != csrB.linhas) {
+        throw runtime_error("As matrizes tem dimensoes incompativeis para multiplicacao.");
+    }
+    EscritorBinario escritorC(arquivoC, leitorA.getLinhas(), n, capacidade);
+
+    vector<double> acumulador(n + 1, 0.0);
+    vector<int> marcador(n + 1, 0);
+    vector<int> cols;
+    vector<double> valores;
+    cols.reserve(n);
+    valores.reserve(n);
+
+    while(leitorA.proximoBloco()) {
+        for(int i = leitorA.inicioBloco(); i < leitorA.fimBloco(); ++i) {
+            cols.clear();
+            valores.clear();
+            multiplicarLinha(leitorA.colunasLinha(i), leitorA.valoresLinha(i), leitorA.tamanhoLinha(i), csrB,
+                             acumulador, marcador, i, cols, valores);
+            escritorC.gravarLinha(cols.data(), valores.data(), static_cast<int>(cols.size()));
+        }
+    }
+    escritorC.finalizar();
+    return escritorC.nnz();
+}
+
+/* Calcula a transposta de uma matriz esparsa e retorna uma nova matriz com o resultado.
+ * Percorre cada coluna j de A pelas listas de coluna, em ordem crescente de linha.
+ * Os elementos da coluna j formam, já ordenados, a linha j da transposta.
+ * Cada linha é preenchida de uma só vez, com custo total proporcional aos elementos não nulos.
+ * Se a matriz estiver congelada, usa a forma CSC já construída ou transpõe a forma CSR por contagem.
+ */
+template <typename T, typename Index>
+SparseMatrixT<T, Index>* transpose(const SparseMatrixT<T, Index>* A) {
+    if(A->isFrozen()) {
+        return A->getCSC() ? new SparseMatrixT<T, Index>(*A->getCSC()) : new SparseMatrixT<T, Index>(transpor(*A->getCSR()));
+    }
+
+    SparseMatrixT<T, Index>* transposta = new SparseMatrixT<T, Index>(A->getColunas(), A->getLinhas());
+    PERFIL(A->contarSaltos(static_cast<long long>(A->countNonZero()) + A->getColunas());)
+
+    vector<Index> cols;
+    vector<T> valores;
+    for(Index j = 1; j <= A->getColunas(); ++j) {
+        cols.clear();
+        valores.clear();
+        for(const NodeT<T, Index>& elemento : A->coluna(j)) {
+            cols.push_back(elemento.linha);
+            valores.push_back(elemento.valor);
+        }
+        transposta->inserirLinha(j, cols, valores);
+    }
+
+    return transposta;
+}
+
+/* Calcula a linha j do triângulo superior de X^T * X pelo algoritmo de Gustavson
+ * Cada elemento X(i, j) da coluna j é dado pela sua posição k nos vetores de X; como as linhas de X são ordenadas,
+ * os elementos de X(i, :) a partir de k são exatamente os de coluna >= j, e só eles são multiplicados por X(i, j)
+ * Acrescenta as colunas e os valores não nulos da linha ao final de cols/valores, como multiplicarLinha
+ */
+template <typename T, typename Index>
+static void multiplicarLinhaSuperior(const CSRViewT<T, Index>& X, const Index* posicoes, const Index* linhasX, Index n,
+                                     vector<T>& acumulador, vector<Index>& marcador, Index marca,
+                                     vector<Index>& cols, vector<T>& valores) {
+    size_t inicio = cols.size();
+    for(Index p = 0; p < n; ++p) {
+        for(Index k = posicoes[p]; k < X.row_ptr[linhasX[p]]; ++k) {
+            Index j = X.col_idx[k];
+            if(marcador[j] != marca) {
+                marcador[j] = marca;
+                cols.push_back(j);
+            }
+        }
+    }
+    if(cols.size() == inicio) return;
+    sort(cols.begin() + inicio, cols.end());
+
+    for(Index p = 0; p < n; ++p) {
+        T valorX = X.values[posicoes[p]];
+        for(Index k = posicoes[p]; k < X.row_ptr[linhasX[p]]; ++k) {
+            acumulador[X.col_idx[k]] += valorX * X.values[k];
+        }
+    }
+
+    size_t total = inicio;
+    for(size_t k = inicio; k < cols.size(); ++k) {
+        Index j = cols[k];
+        if(acumulador[j] != T()) {
+            cols[total++] = j;
+            valores.push_back(acumulador[j]);
+        }
+        acumulador[j] = T();
+    }
+    cols.resize(total);
+}
+
+/* Calcula X^T * X, que é simétrica, e retorna uma nova matriz com o resultado
+ * Agrupa os elementos de X por coluna (ordenação por contagem), guardando a linha e a posição de cada um
+ * Calcula apenas o triângulo superior, com a diagonal: cada produto X(i, j) * X(i, l) com j <= l é feito uma
+ * única vez, quase metade dos produtos de multiply(transpose(X), X)
+ * Com o pool de threads e trabalho suficiente, divide as linhas do triângulo em blocos de custo parecido
+ * Monta cada linha j do resultado com o espelho do triângulo (a coluna j acima da diagonal) seguido da linha j,
+ * gravada com somarLinha, que não liga as colunas; elas são religadas uma única vez ao final
+ */
+template <typename T, typename Index>
+static SparseMatrixT<T, Index>* gramCSR(const CSRViewT<T, Index>& X) {
+    Index n = X.colunas;
+    Index nnz = X.nnz();
+
+    vector<Index> inicioColuna(n + 1, 0);
+    for(Index k = 0; k < nnz; ++k) {
+        inicioColuna[X.col_idx[k]]++;
+    }
+    for(Index j = 1; j <= n; ++j) {
+        inicioColuna[j] += inicioColuna[j - 1];
+    }
+    vector<Index> posicoes(nnz), linhasX(nnz);
+    vector<Index> proximo(inicioColuna.begin(), inicioColuna.end() - 1);
+    for(Index i = 1; i <= X.linhas; ++i) {
+        for(Index k = X.row_ptr[i - 1]; k < X.row_ptr[i]; ++k) {
+            Index destino = proximo[X.col_idx[k] - 1]++;
+            posicoes[destino] = k;
+            linhasX[destino] = i;
+        }
+    }
+
+    vector<long long> custo(n + 1, 0);
+    for(Index j = 1; j <= n; ++j) {
+        long long produtos = 1;
+        for(Index p = inicioColuna[j - 1]; p < inicioColuna[j]; ++p) {
+            produtos += X.row_ptr[linhasX[p]] - posicoes[p];
+        }
+        custo[j] = custo[j - 1] + produtos;
+    }
+
+    ThreadPool* pool = poolOperacoes && custo[n] - n >= TRABALHO_MINIMO_PARALELO ? poolOperacoes.get() : nullptr;
+    int nBlocos = pool ? static_cast<int>(min<Index>(n, pool->tamanho() * BLOCOS_POR_THREAD)) : 1;
+    int trabalhadores = pool ? pool->tamanho() : 1;
+    vector<Index> fronteiras = dividirPorCusto<Index>(custo, nBlocos);
+
+    vector<vector<T>> acumuladores(trabalhadores, vector<T>(n + 1, T()));
+    vector<vector<Index>> marcadores(trabalhadores, vector<Index>(n + 1, 0));
+    vector<CSRMatrixT<T, Index>> blocos(nBlocos);
+    auto calcularBloco = [&](int b, int trabalhador) {
+        CSRMatrixT<T, Index>& bloco = blocos[b];
+        bloco.row_ptr.push_back(0);
+        for(Index j = fronteiras[b]; j < fronteiras[b + 1]; ++j) {
+            Index p = inicioColuna[j - 1];
+            multiplicarLinhaSuperior(X, posicoes.data() + p, linhasX.data() + p, inicioColuna[j] - p,
+                                     acumuladores[trabalhador], marcadores[trabalhador], j,
+                                     bloco.col_idx, bloco.values);
+            bloco.row_ptr.push_back(bloco.nnz());
+        }
+    };
+    if(pool) {
+        pool->executar(nBlocos, calcularBloco);
+    } else {
+        calcularBloco(0, 0);
+    }
+
+    vector<Index> inicioEspelho(n + 1, 0);
+    for(int b = 0; b < nBlocos; ++b) {
+        for(Index k = 0; k < blocos[b].nnz(); ++k) {
+            inicioEspelho[blocos[b].col_idx[k]]++;
+        }
+    }
+    for(Index j = 1; j <= n; ++j) {
+        inicioEspelho[j] += inicioEspelho[j - 1];
+    }
+    vector<Index> colsEspelho(inicioEspelho[n]);
+    vector<T> valoresEspelho(inicioEspelho[n]);
+    proximo.assign(inicioEspelho.begin(), inicioEspelho.end() - 1);
+    for(int b = 0; b < nBlocos; ++b) {
+        const CSRMatrixT<T, Index>& bloco = blocos[b];
+        for(Index i = fronteiras[b]; i < fronteiras[b + 1]; ++i) {
+            for(Index k = bloco.row_ptr[i - fronteiras[b]]; k < bloco.row_ptr[i - fronteiras[b] + 1]; ++k) {
+                Index destino = proximo[bloco.col_idx[k] - 1]++;
+                colsEspelho[destino] = i;
+                valoresEspelho[destino] = bloco.values[k];
+            }
+        }
+    }
+
+    SparseMatrixT<T, Index>* C = new SparseMatrixT<T, Index>(n, n);
+    vector<Index> cols;
+    vector<T> valores;
+    for(int b = 0; b < nBlocos; ++b) {
+        const CSRMatrixT<T, Index>& bloco = blocos[b];
+        for(Index j = fronteiras[b]; j < fronteiras[b + 1]; ++j) {
+            cols.clear();
+            valores.clear();
+            for(Index k = inicioEspelho[j - 1]; k < inicioEspelho[j] && colsEspelho[k] < j; ++k) {
+                cols.push_back(colsEspelho[k]);
+                valores.push_back(valoresEspelho[k]);
+            }
+            Index k0 = bloco.row_ptr[j - fronteiras[b]], k1 = bloco.row_ptr[j - fronteiras[b] + 1];
+            cols.insert(cols.end(), bloco.col_idx.begin() + k0, bloco.col_idx.begin() + k1);
+            valores.insert(valores.end(), bloco.values.begin() + k0, bloco.values.begin() + k1);
+            C->somarLinha(j, cols.data(), valores.data(), static_cast<Index>(cols.size()));
+        }
+    }
+    C->religarColunas();
+
+    return C;
+}
+
+/* Calcula A^T * A e retorna uma nova matriz com o resultado
+ * Usa a forma CSR da matriz congelada ou uma cópia das linhas, e calcula só o triângulo superior (gramCSR)
+ */
+template <typename T, typename Index>
+SparseMatrixT<T, Index>* multiplyATA(const SparseMatrixT<T, Index>* A) {
+    if(A->isFrozen()) {
+        return gramCSR(*A->getCSR());
+    }
+    return gramCSR(CSRViewT<T, Index>(A->toCSR()));
+}
+
+/* Calcula A * A^T e retorna uma nova matriz com o resultado
+ * A * A^T é (A^T)^T * A^T: usa a forma CSC da matriz congelada, que é a forma CSR de A^T, ou a obtém transpondo
+ * a forma CSR por contagem, e calcula só o triângulo superior (gramCSR)
+ */
+template <typename T, typename Index>
+SparseMatrixT<T, Index>* multiplyAAT(const SparseMatrixT<T, Index>* A) {
+    if(A->getCSC()) {
+        return gramCSR(*A->getCSC());
+    }
+    if(A->isFrozen()) {
+        return gramCSR(CSRViewT<T, Index>(transpor(*A->getCSR())));
+    }
+    return gramCSR(CSRViewT<T, Index>(transpor(A->toCSR())));
+}
+
+/* Produto escalar de uma linha CSR com o vetor x, para qualquer tipo de valor e de índice
+ * Usa o laço escalar; as versões abaixo, para double e float com índices int, são vetorizadas
+ */
+template <typename T, typename Index>
+static inline T produtoLinha(const Index* cols, const T* valores, Index n, const T* x) {
+    T total = T();
+    for(Index k = 0; k < n; ++k) {
+        total += valores[k] * x[cols[k] - 1];
+    }
+    return total;
+}
+
+/* Produto escalar de uma linha CSR com o vetor x
+ * Com AVX-512 ou AVX2+FMA disponíveis na compilação, busca 8 ou 4 elementos de x por vez
+ * com instruções de gather e acumula com FMA; os elementos restantes são somados um a um
+ * No AVX-512, o gather e a extração das metades para a redução usam as versões mascaradas sobre um
+ * registrador zerado: as versões sem máscara (inclusive as de _mm512_reduce_add_pd) partem de um
+ * registrador não inicializado, e o g++ 12 avisa com -Wmaybe-uninitialized
+ * Sem essas extensões, usa apenas o laço escalar
+ */
+static inline double produtoLinha(const int* cols, const double* valores, int n, const double* x) {
+    int k = 0;
+    double total = 0.0;
+#if defined(__AVX512F__)
+    __m512d acumulado = _mm512_setzero_pd();
+    const __m256i um = _mm256_set1_epi32(1);
+    for(; k + 8 <= n; k += 8) {
+        __m256i indices = _mm256_sub_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(cols + k)), um);
+        __m512d xs = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, indices, x, 8);
+        acumulado = _mm512_fmadd_pd(_mm512_loadu_pd(valores + k), xs, acumulado);
+    }
+    __m256d quarto = _mm256_add_pd(_mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xF, acumulado, 0),
+                                   _mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xF, acumulado, 1));
+    __m128d metade = _mm_add_pd(_mm256_castpd256_pd128(quarto), _mm256_extractf128_pd(quarto, 1));
+    total = _mm_cvtsd_f64(_mm_add_sd(metade, _mm_unpackhi_pd(metade, metade)));
+#elif defined(__AVX2__) && defined(__FMA__)
+    __m256d acumulado = _mm256_setzero_pd();
+    const __m128i um = _mm_set1_epi32(1);
+    for(; k + 4 <= n; k += 4) {
+        __m128i indices = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(cols + k)), um);
+        __m256d xs = _mm256_i32gather_pd(x, indices, 8);
+        acumulado = _mm256_fmadd_pd(_mm256_loadu_pd(valores + k), xs, acumulado);
+    }
+    __m128d metade = _mm_add_pd(_mm256_castpd256_pd128(acumulado), _mm256_extractf128_pd(acumulado, 1));
+    total = _mm_cvtsd_f64(_mm_add_sd(metade, _mm_unpackhi_pd(metade, metade)));
+#endif
+    for(; k < n; ++k) {
+        total += valores[k] * x[cols[k] - 1];
+    }
+    return total;
+}
+
+/* Versão de produtoLinha para valores float
+ * Cada registrador comporta o dobro de elementos da versão double: busca 16 ou 8 elementos de x por vez
+ * com AVX-512 ou AVX2+FMA, com os mesmos índices de 32 bits; os elementos restantes são somados um a um
+ * No AVX-512, também usa as versões mascaradas sobre registradores zerados; as metades de 256 bits são
+ * extraídas como double, pois a extração de float em oito posições exige AVX512DQ
+ */
+static inline float produtoLinha(const int* cols, const float* valores, int n, const float* x) {
+    int k = 0;
+    float total = 0.0f;
+#if defined(__AVX512F__)
+    __m512 acumulado = _mm512_setzero_ps();
+    const __m512i um = _mm512_set1_epi32(1);
+    for(; k + 16 <= n; k += 16) {
+        __m512i indices = _mm512_sub_epi32(_mm512_loadu_si512(cols + k), um);
+        __m512 xs = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), 0xFFFF, indices, x, 4);
+        acumulado = _mm512_fmadd_ps(_mm512_loadu_ps(valores + k), xs, acumulado);
+    }
+    __m512d bits = _mm512_castps_pd(acumulado);
+    __m256 oitavo = _mm256_add_ps(_mm256_castpd_ps(_mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xF, bits, 0)),
+                                  _mm256_castpd_ps(_mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xF, bits, 1)));
+    __m128 metade = _mm_add_ps(_mm256_castps256_ps128(oitavo), _mm256_extractf128_ps(oitavo, 1));
+    metade = _mm_add_ps(metade, _mm_movehl_ps(metade, metade));
+    total = _mm_cvtss_f32(_mm_add_ss(metade, _mm_shuffle_ps(metade, metade, 1)));
+#elif defined(__AVX2__) && defined(__FMA__)
+    __m256 acumulado = _mm256_setzero_ps();
+    const __m256i um = _mm256_set1_epi32(1);
+    for(; k + 8 <= n; k += 8) {
+        __m256i indices = _mm256_sub_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(cols + k)), um);
+        __m256 xs = _mm256_i32gather_ps(x, indices, 4);
+        acumulado = _mm256_fmadd_ps(_mm256_loadu_ps(valores + k), xs, acumulado);
+    }
+    __m128 metade = _mm_add_ps(_mm256_castps256_ps128(acumulado), _mm256_extractf128_ps(acumulado, 1));
+    metade = _mm_add_ps(metade, _mm_movehl_ps(metade, metade));
+    total = _mm_cvtss_f32(_mm_add_ss(metade, _mm_shuffle_ps(metade, metade, 1)));
+#endif
+    for(; k < n; ++k) {
+        total += valores[k] * x[cols[k] - 1];
+    }
+    return total;
+}
+
+/* Calcula y = A * x sobre a forma CSR
+ * Cada posição de y é o produto escalar de uma linha contígua de A com x
+ * Com mais de uma thread configurada e ao menos TRABALHO_MINIMO_PARALELO elementos e linhas, divide as linhas
+ * em blocos com quantidades parecidas de elementos não nulos; cada thread escreve apenas as posições de y
+ * das suas linhas. Abaixo desse trabalho, o produto é feito na thread que chamou, sem alocar nada.
+ */
+template <typename T, typename Index>
+void spmvCSR(const CSRViewT<T, Index>& A, const T* x, T* y) {
+    auto calcularLinhas = [&](Index inicio, Index fim) {
+        for(Index i = inicio; i < fim; ++i) {
+            Index k = A.row_ptr[i - 1];
+            y[i - 1] = produtoLinha(A.col_idx + k, A.values + k, A.row_ptr[i] - k, x);
+        }
+    };
+
+    if(!poolOperacoes || A.linhas < poolOperacoes->tamanho() ||
+       static_cast<long long>(A.nnz()) + A.linhas < TRABALHO_MINIMO_PARALELO) {
+        calcularLinhas(1, A.linhas + 1);
+        return;
+    }
+
+    int nBlocos = static_cast<int>(min<Index>(A.linhas, poolOperacoes->tamanho() * BLOCOS_POR_THREAD));
+    vector<long long> custo(A.linhas + 1);
+    for(Index i = 0; i <= A.linhas; ++i) {
+        custo[i] = A.row_ptr[i] + i;
+    }
+    vector<Index> fronteiras = dividirPorCusto<Index>(custo, nBlocos);
+    poolOperacoes->executar(nBlocos, [&](int b, int) {
+        calcularLinhas(fronteiras[b], fronteiras[b + 1]);
+    });
+}
+
+/* Multiplica pelo vetor x a matriz representada pelo seu triângulo inferior, sem expandi-la
+ * Cada elemento (i, j) abaixo da diagonal contribui duas vezes: para y[i] com x[j], como em spmvCSR,
+ * e para y[j] com x[i], o elemento espelhado (com o sinal trocado na antissimétrica)
+ * Lê a metade dos elementos que o produto com a matriz completa leria; roda em uma única thread,
+ * pois as contribuições espelhadas de linhas diferentes caem nas mesmas posições de y
+ */
+void spmvSimetrico(const CSRView& triangulo, Simetria simetria, const double* x, double* y) {
+    if(simetria == Simetria::Geral) {
+        spmvCSR(triangulo, x, y);
+        return;
+    }
+
+    double sinal = simetria == Simetria::AntiSimetrica ? -1.0 : 1.0;
+    fill(y, y + triangulo.linhas, 0.0);
+    for(int i = 1; i <= triangulo.linhas; ++i) {
+        double total = 0.0;
+        double xi = sinal * x[i - 1];
+        for(int k = triangulo.row_ptr[i - 1]; k < triangulo.row_ptr[i]; ++k) {
+            int j = triangulo.col_idx[k];
+            total += triangulo.values[k] * x[j - 1];
+            if(j != i) {
+                y[j - 1] += triangulo.values[k] * xi;
+            }
+        }
+        y[i - 1] += total;
+    }
+}
+
+/* Multiplica a matriz A pelo vetor x e retorna y = A * x
+ * Verifica se o tamanho de x é igual ao número de colunas, lançando uma exceção se não for
+ * Se a matriz estiver congelada, usa o núcleo vetorizado sobre a forma CSR
+ * Caso contrário, percorre os nós de cada linha; para muitos produtos com a mesma matriz,
+ * congelá-la antes compensa
+ */
+template <typename T, typename Index>
+vector<T> multiplyVector(const SparseMatrixT<T, Index>* A, const vector<T>& x) {
+    if(static_cast<Index>(x.size()) != A->getColunas()) {
+        throw runtime_error("O vetor tem tamanho incompativel com a matriz.");
+    }
+
+    vector<T> y(A->getLinhas(), T());
+    if(A->isFrozen()) {
+        spmvCSR(*A->getCSR(), x.data(), y.data());
+        return y;
+    }
+
+    PERFIL(A->contarSaltos(static_cast<long long>(A->countNonZero()) + A->getLinhas());)
+    for(Index i = 1; i <= A->getLinhas(); ++i) {
+        NodeT<T, Index>* linha = A->getLinha(i);
+        T total = T();
+        for(NodeT<T, Index>* elemento = linha->direita; elemento != linha; elemento = elemento->direita) {
+            total += elemento->valor * x[elemento->coluna - 1];
+        }
+        y[i - 1] = total;
+    }
+    return y;
+}
+
+/* Multiplica a transposta de A pelo vetor x e retorna y = A^T * x
+ * Verifica se o tamanho de x é igual ao número de linhas, lançando uma exceção se não for
+ * Se a matriz estiver congelada com a forma CSC, usa o núcleo vetorizado sobre ela
+ * Se estiver congelada sem a forma CSC, espalha cada linha de A sobre y
+ * Caso contrário, percorre a lista de cada coluna, com custo proporcional aos elementos não nulos
+ */
+template <typename T, typename Index>
+vector<T> multiplyTransposeVector(const SparseMatrixT<T, Index>* A, const vector<T>& x) {
+    if(static_cast<Index>(x.size()) != A->getLinhas()) {
+        throw runtime_error("O vetor tem tamanho incompativel com a matriz.");
+    }
+
+    vector<T> y(A->getColunas(), T());
+    if(A->isFrozen()) {
+        if(A->getCSC()) {
+            spmvCSR(*A->getCSC(), x.data(), y.data());
+        } else {
+            const CSRViewT<T, Index>& csr = *A->getCSR();
+            for(Index i = 1; i <= csr.linhas; ++i) {
+                for(Index k = csr.row_ptr[i - 1]; k < csr.row_ptr[i]; ++k) {
+                    y[csr.col_idx[k] - 1] += csr.values[k] * x[i - 1];
+                }
+            }
+        }
+        return y;
+    }
+
+    PERFIL(A->contarSaltos(static_cast<long long>(A->countNonZero()) + A->getColunas());)
+    for(Index j = 1; j <= A->getColunas(); ++j) {
+        T total = T();
+        for(const NodeT<T, Index>& elemento : A->coluna(j)) {
+            total += elemento.valor * x[elemento.linha - 1];
+        }
+        y[j - 1] = total;
+    }
+    return y;
+}
+
+#define INSTANCIAR(T, Index)                                                                                        \
+    template SparseMatrixT<T, Index>* sumCSR(const CSRViewT<T, Index>&, const CSRViewT<T, Index>&);                 \
+    template SparseMatrixT<T, Index>* sum(const SparseMatrixT<T, Index>*, const SparseMatrixT<T, Index>*);          \
+    template SparseMatrixT<T, Index>* multiplyCSR(const CSRViewT<T, Index>&, const CSRViewT<T, Index>&);            \
+    template SparseMatrixT<T, Index>* multiply(const SparseMatrixT<T, Index>*, const SparseMatrixT<T, Index>*);     \
+    template SparseMatrixT<T, Index> operator+(const SparseMatrixT<T, Index>&, const SparseMatrixT<T, Index>&);     \
+    template SparseMatrixT<T, Index> operator+(SparseMatrixT<T, Index>&&, const SparseMatrixT<T, Index>&);          \
+    template SparseMatrixT<T, Index> operator+(const SparseMatrixT<T, Index>&, SparseMatrixT<T, Index>&&);          \
+    template SparseMatrixT<T, Index> operator+(SparseMatrixT<T, Index>&&, SparseMatrixT<T, Index>&&);               \
+    template SparseMatrixT<T, Index> operator*(const SparseMatrixT<T, Index>&, const SparseMatrixT<T, Index>&);     \
+    template SparseMatrixT<T, Index>* transpose(const SparseMatrixT<T, Index>*);                                    \
+    template SparseMatrixT<T, Index>* multiplyATA(const SparseMatrixT<T, Index>*);                                  \
+    template SparseMatrixT<T, Index>* multiplyAAT(const SparseMatrixT<T, Index>*);                                  \
+    template void spmvCSR(const CSRViewT<T, Index>&, const T*, T*);                                                 \
+    template vector<T> multiplyVector(const SparseMatrixT<T, Index>*, const vector<T>&);                            \
+    template vector<T> multiplyTransposeVector(const SparseMatrixT<T, Index>*, const vector<T>&);
+PARA_CADA_TIPO_MATRIZ(INSTANCIAR)
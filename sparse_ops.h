@@ -0,0 +1,86 @@
+#ifndef SPARSE_OPS_H
+#define SPARSE_OPS_H
+
+#include "sparse_matrix.h"
+#include "csr_matrix.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Operações entre matrizes esparsas. Todas retornam uma nova matriz alocada com new.
+// As operações sobre SparseMatrixT são instanciadas para as combinações de tipos de matrix_types.h.
+
+// Define quantas threads sum e multiply usam (1 = execução sequencial, o padrão)
+void setNumThreads(int n);
+
+// Retorna quantas threads sum e multiply usam
+int getNumThreads();
+
+// Soma duas matrizes na forma CSR
+template <typename T, typename Index>
+SparseMatrixT<T, Index>* sumCSR(const CSRViewT<T, Index>& A, const CSRViewT<T, Index>& B);
+
+// Soma duas matrizes esparsas de mesmas dimensões
+template <typename T, typename Index>
+SparseMatrixT<T, Index>* sum(const SparseMatrixT<T, Index>* A, const SparseMatrixT<T, Index>* B);
+
+// Multiplica duas matrizes na forma CSR
+template <typename T, typename Index>
+SparseMatrixT<T, Index>* multiplyCSR(const CSRViewT<T, Index>& A, const CSRViewT<T, Index>& B);
+
+// Multiplica duas matrizes esparsas (colunas de A == linhas de B)
+// Matrizes com blocos densos são multiplicadas na forma BSR (bsr_matrix.h), bloco a bloco
+template <typename T, typename Index>
+SparseMatrixT<T, Index>* multiply(const SparseMatrixT<T, Index>* A, const SparseMatrixT<T, Index>* B);
+
+// Multiplica as matrizes gravadas no formato binário em arquivoA e arquivoB e grava C = A * B em arquivoC
+// A é lida e C é gravada em blocos de linhas, sem que nenhuma das duas fique inteira na memória; B fica mapeada
+// A memória usada pela operação, incluindo B, não passa de memoriaMaxima bytes; retorna os elementos não nulos de C
+long long multiplyStreaming(const std::string& arquivoA, const std::string& arquivoB, const std::string& arquivoC,
+                            std::size_t memoriaMaxima);
+
+// Operadores com semântica de valor sobre sum e multiply; o resultado é movido para o retorno, sem cópia
+template <typename T, typename Index>
+SparseMatrixT<T, Index> operator+(const SparseMatrixT<T, Index>& A, const SparseMatrixT<T, Index>& B);
+template <typename T, typename Index>
+SparseMatrixT<T, Index> operator*(const SparseMatrixT<T, Index>& A, const SparseMatrixT<T, Index>& B);
+
+// Somas com um operando temporário: o resultado é acumulado nele (com axpy) em vez de em uma nova matriz
+template <typename T, typename Index>
+SparseMatrixT<T, Index> operator+(SparseMatrixT<T, Index>&& A, const SparseMatrixT<T, Index>& B);
+template <typename T, typename Index>
+SparseMatrixT<T, Index> operator+(const SparseMatrixT<T, Index>& A, SparseMatrixT<T, Index>&& B);
+template <typename T, typename Index>
+SparseMatrixT<T, Index> operator+(SparseMatrixT<T, Index>&& A, SparseMatrixT<T, Index>&& B);
+
+// Calcula a transposta de uma matriz esparsa
+template <typename T, typename Index>
+SparseMatrixT<T, Index>* transpose(const SparseMatrixT<T, Index>* A);
+
+// Calcula A^T * A, sem montar a transposta, calculando só o triângulo superior e espelhando-o
+template <typename T, typename Index>
+SparseMatrixT<T, Index>* multiplyATA(const SparseMatrixT<T, Index>* A);
+
+// Calcula A * A^T, sem montar a transposta, calculando só o triângulo superior e espelhando-o
+template <typename T, typename Index>
+SparseMatrixT<T, Index>* multiplyAAT(const SparseMatrixT<T, Index>* A);
+
+// Produto da matriz CSR A pelo vetor x: y = A * x
+// x tem A.colunas posições e y tem A.linhas posições; a coluna j corresponde a x[j - 1]
+// Para double e float com índices int, o produto de cada linha é vetorizado quando AVX2+FMA ou AVX-512 estão disponíveis
+template <typename T, typename Index>
+void spmvCSR(const CSRViewT<T, Index>& A, const T* x, T* y);
+
+// Produto de uma matriz simétrica ou antissimétrica, guardada apenas pelo triângulo inferior, pelo vetor x: y = A * x
+// Usa o triângulo sem montar a matriz completa; com Simetria::Geral, equivale a spmvCSR
+void spmvSimetrico(const CSRView& triangulo, Simetria simetria, const double* x, double* y);
+
+// Multiplica a matriz A pelo vetor x (y = A * x)
+template <typename T, typename Index>
+std::vector<T> multiplyVector(const SparseMatrixT<T, Index>* A, const std::vector<T>& x);
+
+// Multiplica a transposta de A pelo vetor x (y = A^T * x)
+template <typename T, typename Index>
+std::vector<T> multiplyTransposeVector(const SparseMatrixT<T, Index>* A, const std::vector<T>& x);
+
+#endif
@@ -0,0 +1,126 @@
+#include "thread_pool.h"
+
+using namespace std;
+
+/* Cria o pool com n threads no total
+ * Garante ao menos uma thread; as n - 1 auxiliares ficam aguardando lotes
+ */
+ThreadPool::ThreadPool(int n) {
+    if (n < 1) n = 1;
+    faixas.reset(new Faixa[n]);
+    for (int t = 1; t < n; ++t) {
+        auxiliares.emplace_back(&ThreadPool::laco, this, t);
+    }
+}
+
+/* Sinaliza o encerramento e aguarda o fim de todas as threads auxiliares
+ */
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> trava(mtx);
+        encerrar = true;
+    }
+    inicioLote.notify_all();
+    for (thread& t : auxiliares) {
+        t.join();
+    }
+}
+
+/* Executa um lote de tarefas e aguarda o seu término
+ * Obtém o pool com exclusividade, pois as faixas e a tarefa atual são do lote inteiro
+ * Divide as tarefas em faixas contíguas de tamanhos parecidos, uma por thread
+ * Acorda as threads auxiliares e participa do trabalho como trabalhador 0
+ * As travas são usadas apenas para iniciar e concluir o lote, nunca por tarefa
+ * Relança a exceção de uma tarefa só depois que todas as threads deixaram o lote
+ */
+void ThreadPool::executar(int nTarefas, const function<void(int, int)>& tarefa) {
+    lock_guard<mutex> exclusivo(mtxLote);
+    int n = tamanho();
+    for (int t = 0; t < n; ++t) {
+        faixas[t].proximo.store(static_cast<int>(static_cast<long long>(nTarefas) * t / n), memory_order_relaxed);
+        faixas[t].fim = static_cast<int>(static_cast<long long>(nTarefas) * (t + 1) / n);
+    }
+    tarefaAtual = &tarefa;
+
+    if (n > 1) {
+        {
+            lock_guard<mutex> trava(mtx);
+            lote++;
+            pendentes = n - 1;
+        }
+        inicioLote.notify_all();
+    }
+
+    consumir(0);
+
+    if (n > 1) {
+        unique_lock<mutex> trava(mtx);
+        fimLote.wait(trava, [this] { return pendentes == 0; });
+    }
+    tarefaAtual = nullptr;
+
+    if (erro) {
+        exception_ptr e = erro;
+        erro = nullptr;
+        rethrow_exception(e);
+    }
+}
+
+/* Laço de uma thread auxiliar
+ * Aguarda o início de um novo lote ou o encerramento do pool
+ * Consome tarefas do lote e avisa quando não houver mais nada a fazer
+ */
+void ThreadPool::laco(int trabalhador) {
+    long long ultimoLote = 0;
+    while (true) {
+        {
+            unique_lock<mutex> trava(mtx);
+            inicioLote.wait(trava, [&] { return encerrar || lote != ultimoLote; });
+            if (encerrar) return;
+            ultimoLote = lote;
+        }
+
+        consumir(trabalhador);
+
+        {
+            lock_guard<mutex> trava(mtx);
+            pendentes--;
+        }
+        fimLote.notify_one();
+    }
+}
+
+/* Consome tarefas até que todas as faixas estejam esgotadas
+ * Começa pela própria faixa e depois percorre as faixas das demais threads
+ * Cada tarefa é reservada com um incremento atômico, então nenhuma é executada duas vezes
+ * Uma exceção não sai da thread: abandona o lote para que todas as threads terminem logo
+ */
+void ThreadPool::consumir(int trabalhador) {
+    int n = tamanho();
+    for (int k = 0; k < n; ++k) {
+        Faixa& faixa = faixas[(trabalhador + k) % n];
+        while (true) {
+            int t = faixa.proximo.fetch_add(1, memory_order_relaxed);
+            if (t >= faixa.fim) break;
+            try {
+                (*tarefaAtual)(t, trabalhador);
+            } catch (...) {
+                abandonarLote(current_exception());
+            }
+        }
+    }
+}
+
+/* Guarda a exceção, se for a primeira do lote, e esgota todas as faixas
+ * As tarefas já reservadas terminam normalmente; as próximas reservas encontram a faixa no fim
+ */
+void ThreadPool::abandonarLote(exception_ptr e) {
+    {
+        lock_guard<mutex> trava(mtx);
+        if (!erro) erro = e;
+    }
+    int n = tamanho();
+    for (int k = 0; k < n; ++k) {
+        faixas[k].proximo.store(faixas[k].fim, memory_order_relaxed);
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Definição da classe ThreadPool, um conjunto fixo de threads para executar lotes de tarefas
+// Cada lote é dividido em faixas contíguas de tarefas, uma por thread. Quem esgota a própria faixa
+// rouba tarefas das faixas das outras threads, sem travas, o que equilibra lotes desiguais.
+class ThreadPool {
+public:
+    // Cria um pool com n threads no total; a thread que chama executar() é uma delas
+    explicit ThreadPool(int n);
+
+    // Destrutor da classe, encerra e aguarda as threads auxiliares
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Retorna o número total de threads do pool
+    int tamanho() const { return static_cast<int>(auxiliares.size()) + 1; }
+
+    // Executa tarefa(t, trabalhador) para t em [0, nTarefas) e aguarda o fim de todas
+    // O índice do trabalhador (0 <= trabalhador < tamanho()) permite usar áreas de trabalho privadas
+    // Pode ser chamada por várias threads: os lotes são executados um de cada vez, na ordem em que obtêm o pool;
+    // uma tarefa não pode chamar executar() no mesmo pool
+    // Se uma tarefa lançar uma exceção, as tarefas ainda não iniciadas são abandonadas e, depois que o lote
+    // termina, a primeira exceção é relançada para quem chamou
+    void executar(int nTarefas, const std::function<void(int tarefa, int trabalhador)>& tarefa);
+
+private:
+    // Faixa de tarefas de uma thread, alinhada para que threads diferentes não disputem a mesma linha de cache
+    struct alignas(64) Faixa {
+        std::atomic<int> proximo{0};
+        int fim = 0;
+    };
+
+    // Laço das threads auxiliares: aguarda um lote, consome tarefas e sinaliza o término
+    void laco(int trabalhador);
+
+    // Executa tarefas da própria faixa e depois rouba das faixas das outras threads
+    void consumir(int trabalhador);
+
+    // Guarda a primeira exceção do lote e esgota todas as faixas
+    void abandonarLote(std::exception_ptr e);
+
+    std::vector<std::thread> auxiliares;
+    std::unique_ptr<Faixa[]> faixas;
+    const std::function<void(int, int)>* tarefaAtual = nullptr;
+
+    std::mutex mtxLote;    // Mantida durante todo o lote: só uma chamada de executar() usa as faixas por vez
+    std::mutex mtx;
+    std::condition_variable inicioLote, fimLote;
+    long long lote = 0;    // Identificador do lote atual
+    int pendentes = 0;     // Threads auxiliares que ainda não terminaram o lote
+    bool encerrar = false;
+    std::exception_ptr erro; // Primeira exceção lançada por uma tarefa do lote atual
+};
+
+#endif